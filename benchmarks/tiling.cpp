@@ -0,0 +1,79 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * Compares plain CRS and column-tiled vector multiplication on matrices of
+ * growing width. Tiling starts to win once the multiplied vector no longer
+ * fits into the cache.
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <chrono>
+#include <random>
+#include <cstdio>
+#include <functional>
+#include <vector>
+#include "../src/SparseMatrix/SparseMatrix.h"
+#include "../src/SparseMatrix/TiledSparseMatrix.h"
+
+
+template<typename F>
+double measure(F f, int repeats)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int r = 0; r < repeats; r++) {
+		f();
+	}
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / repeats;
+}
+
+
+int main(void)
+{
+	const size_t rows = 1 << 17, perRow = 16;
+	const int repeats = 5;
+
+	std::mt19937_64 random(42);
+	std::uniform_real_distribution<double> value(-1.0, 1.0);
+
+	std::printf("%12s %10s %12s %12s %10s\n", "columns", "x [KiB]", "CRS [ms]", "tiled [ms]", "speedup");
+
+	for (size_t cols = 1 << 12; cols <= (1 << 24); cols <<= 2) {
+		// set() shifts row pointers of all following rows, so fill small blocks and stack them
+		const size_t blockRows = 64;
+		std::uniform_int_distribution<size_t> column(0, cols - 1);
+
+		std::vector<Sparse::SparseMatrix<double> > blocks;
+		for (size_t first = 0; first < rows; first += blockRows) {
+			blocks.push_back(Sparse::SparseMatrix<double>(blockRows, cols));
+
+			for (size_t i = 0; i < blockRows; i++) {
+				for (size_t k = 0; k < perRow; k++) {
+					blocks.back().set(value(random), i, column(random));
+				}
+			}
+		}
+
+		Sparse::SparseMatrix<double> matrix = Sparse::SparseMatrix<double>::vstack(
+			std::vector<std::reference_wrapper<const Sparse::SparseMatrix<double> > >(blocks.begin(), blocks.end()));
+
+		std::vector<double> x(cols);
+		for (size_t j = 0; j < cols; j++) {
+			x[j] = value(random);
+		}
+
+		Sparse::TiledSparseMatrix<double> tiled(matrix);
+
+		double crs = measure([&] () { matrix.multiply(x); }, repeats);
+		double tiledTime = measure([&] () { tiled.multiply(x); }, repeats);
+
+		std::printf("%12zu %10zu %12.3f %12.3f %9.2fx\n", cols, cols * sizeof(double) / 1024, crs, tiledTime, crs / tiledTime);
+	}
+
+	return 0;
+}
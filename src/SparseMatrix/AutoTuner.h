@@ -0,0 +1,444 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_AUTOTUNER_H__
+
+	#define	__SPARSEMATRIX_AUTOTUNER_H__
+
+	#include <chrono>
+	#include <memory>
+	#include <string>
+	#include <vector>
+	#include <cstdint>
+	#include <fstream>
+	#include <algorithm>
+	#include <functional>
+	#include "exceptions.h"
+	#include "SparseMatrix.h"
+	#include "DeltaSparseMatrix.h"
+	#include "DiagonalSparseMatrix.h"
+	#include "TiledSparseMatrix.h"
+	#include "HybridSparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		enum class StorageFormat
+		{
+			CRS,
+			DELTA, // DeltaSparseMatrix
+			DIAGONAL, // DiagonalSparseMatrix
+			TILED, // TiledSparseMatrix
+			HYBRID // HybridSparseMatrix
+		};
+
+
+		inline const char * getFormatName(StorageFormat format)
+		{
+			static const char * names[] = { "CRS", "DELTA", "DIAGONAL", "TILED", "HYBRID" };
+			return names[static_cast<int>(format)];
+		}
+
+
+		struct MatrixFeatures
+		{
+			size_t rows, columns, nnz;
+			double rowMean, rowVariance; // non-zero elements per row
+			size_t rowMax;
+			size_t bandwidth; // largest |column - row|
+			size_t gapMax; // largest gap between neighbouring columns of a row
+			double diagonalFill; // DIA stored elements per non-zero element
+			double blockDensity; // non-zero share of occupied 4×4 blocks
+			bool symmetric;
+		};
+
+
+		template<typename T>
+		class AutoTuner;
+
+
+		/** Vector multiplication by a matrix stored in the format chosen by AutoTuner */
+		template<typename T>
+		class OptimizedOperator
+		{
+
+			public:
+
+				size_t getRowCount(void) const
+				{
+					return this->m;
+				}
+
+
+				size_t getColumnCount(void) const
+				{
+					return this->n;
+				}
+
+
+				StorageFormat getFormat(void) const
+				{
+					return this->format;
+				}
+
+
+				std::vector<T> multiply(const std::vector<T> & x) const
+				{
+					return this->kernel(x);
+				}
+
+
+				std::vector<T> operator * (const std::vector<T> & x) const
+				{
+					return this->kernel(x);
+				}
+
+
+			protected:
+
+				friend class AutoTuner<T>;
+
+				size_t m, n;
+				StorageFormat format;
+				std::function<std::vector<T>(const std::vector<T> &)> kernel; // owns the converted matrix
+
+
+				OptimizedOperator(size_t m, size_t n, StorageFormat format, std::function<std::vector<T>(const std::vector<T> &)> kernel)
+					: m(m), n(n), format(format), kernel(std::move(kernel))
+				{}
+
+		};
+
+
+		/**
+		 * Picks the storage format for vector multiplication by a given matrix.
+		 *
+		 * The choice follows features of the matrix, or the fastest candidate when
+		 * benchmarking is enabled. Decisions can be cached in a file keyed by the
+		 * pattern fingerprint, so later runs skip the analysis.
+		 */
+		template<typename T>
+		class AutoTuner
+		{
+
+			public:
+
+				struct Options
+				{
+					bool benchmark; // time candidate formats instead of heuristics
+					size_t repetitions; // multiplications per candidate, the fastest one counts
+					std::string cacheFile; // empty means no cache
+
+					Options(void) : benchmark(false), repetitions(5)
+					{}
+				};
+
+
+				// vectors bigger than this don't fit the cache, tiling pays off
+				static const size_t LARGE_VECTOR_BYTES = 8 << 20;
+
+
+				static MatrixFeatures analyze(const SparseMatrix<T> & matrix);
+				static uint64_t fingerprint(const SparseMatrix<T> & matrix); // dimensions, pattern and element size
+
+				static StorageFormat choose(const MatrixFeatures & features); // heuristic choice
+				static OptimizedOperator<T> create(const SparseMatrix<T> & matrix, StorageFormat format);
+
+				static OptimizedOperator<T> tune(const SparseMatrix<T> & matrix, const Options & options = Options());
+
+
+			protected:
+
+				static bool findCached(const std::string & file, uint64_t fingerprint, StorageFormat & format);
+				static void storeCached(const std::string & file, uint64_t fingerprint, StorageFormat format);
+
+				static StorageFormat benchmark(const SparseMatrix<T> & matrix, const MatrixFeatures & features, size_t repetitions);
+
+		};
+
+
+    // === ANALYSIS ==============================================
+
+    template<typename T>
+    MatrixFeatures AutoTuner<T>::analyze(const SparseMatrix<T> & matrix)
+    {
+        MatrixFeatures features;
+        features.rows = matrix.getRowCount();
+        features.columns = matrix.getColumnCount();
+        features.nnz = matrix.getNnz();
+        features.rowMean = features.rows == 0 ? 0.0 : static_cast<double>(features.nnz) / features.rows;
+        features.rowVariance = 0.0;
+        features.rowMax = 0;
+        features.bandwidth = 0;
+        features.gapMax = 0;
+        features.diagonalFill = DiagonalSparseMatrix<T>::fillRatio(matrix);
+
+        const std::vector<size_t> & rows = *(matrix.rows);
+        const size_t * cols = features.nnz == 0 ? nullptr : matrix.cols->data();
+
+        for (size_t i = 0; i < features.rows; i++) {
+            size_t length = rows[i + 1] - rows[i];
+            double deviation = length - features.rowMean;
+
+            features.rowVariance += deviation * deviation;
+            features.rowMax = std::max(features.rowMax, length);
+
+            // columns are sorted, the first and last ones are the farthest
+            if (length != 0) {
+                size_t first = cols[rows[i]], last = cols[rows[i + 1] - 1];
+                features.bandwidth = std::max(features.bandwidth, std::max(i > first ? i - first : first - i, i > last ? i - last : last - i));
+            }
+
+            for (size_t pos = rows[i] + 1; pos < rows[i + 1]; pos++) {
+                features.gapMax = std::max(features.gapMax, cols[pos] - cols[pos - 1]);
+            }
+        }
+
+        if (features.rows != 0) {
+            features.rowVariance /= features.rows;
+        }
+
+        // distinct 4×4 blocks of every block row
+        size_t blocks = 0;
+        std::vector<size_t> blockCols;
+
+        for (size_t first = 0; first < features.rows; first += 4) {
+            blockCols.clear();
+
+            for (size_t pos = rows[first]; pos < rows[std::min(first + 4, features.rows)]; pos++) {
+                blockCols.push_back(cols[pos] / 4);
+            }
+
+            std::sort(blockCols.begin(), blockCols.end());
+            blocks += std::unique(blockCols.begin(), blockCols.end()) - blockCols.begin();
+        }
+
+        features.blockDensity = blocks == 0 ? 0.0 : static_cast<double>(features.nnz) / (blocks * 16);
+        features.symmetric = features.rows == features.columns;
+
+        // every element looked up on the mirrored position, no transposed copy
+        for (size_t i = 0; features.symmetric && i < features.rows; i++) {
+            for (size_t pos = rows[i]; pos < rows[i + 1]; pos++) {
+                size_t j = cols[pos];
+                const size_t * mirror = std::lower_bound(cols + rows[j], cols + rows[j + 1], i);
+
+                if (mirror == cols + rows[j + 1] || *mirror != i || !((*(matrix.vals))[mirror - cols] == (*(matrix.vals))[pos])) {
+                    features.symmetric = false;
+                    break;
+                }
+            }
+        }
+
+        return features;
+    }
+
+
+    template<typename T>
+    uint64_t AutoTuner<T>::fingerprint(const SparseMatrix<T> & matrix)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+
+        auto mix = [&hash] (uint64_t value) {
+            for (int b = 0; b < 8; b++) {
+                hash ^= (value >> (8 * b)) & 0xFF;
+                hash *= 1099511628211ull;
+            }
+        };
+
+        mix(matrix.getRowCount());
+        mix(matrix.getColumnCount());
+        mix(sizeof(T));
+
+        for (size_t i = 0; i <= matrix.getRowCount(); i++) {
+            mix((*(matrix.rows))[i]);
+        }
+
+        for (size_t pos = 0; pos < matrix.getNnz(); pos++) {
+            mix((*(matrix.cols))[pos]);
+        }
+
+        return hash;
+    }
+
+
+    // === DECISION ==============================================
+
+    template<typename T>
+    StorageFormat AutoTuner<T>::choose(const MatrixFeatures & features)
+    {
+        if (features.nnz != 0 && features.diagonalFill <= static_cast<double>(sizeof(T) + sizeof(size_t)) / sizeof(T)) {
+            return StorageFormat::DIAGONAL;
+        }
+
+        // small matrices stay in cache anyway
+        if (features.nnz < Parallel::MINIMUM_WORK) {
+            return StorageFormat::CRS;
+        }
+
+        // hub rows would keep one thread busy while the others wait
+        if (features.rowMax > HybridSparseMatrix<T>::defaultThreshold(features.rows, features.nnz)) {
+            return StorageFormat::HYBRID;
+        }
+
+        // with all gaps within a byte every index shrinks to about a byte
+        if (features.gapMax <= UINT8_MAX) {
+            return StorageFormat::DELTA;
+        }
+
+        if (features.columns * sizeof(T) > LARGE_VECTOR_BYTES && features.rowMean >= 4) {
+            return StorageFormat::TILED;
+        }
+
+        return StorageFormat::CRS;
+    }
+
+
+    template<typename T>
+    OptimizedOperator<T> AutoTuner<T>::create(const SparseMatrix<T> & matrix, StorageFormat format)
+    {
+        size_t m = matrix.getRowCount(), n = matrix.getColumnCount();
+
+        switch (format) {
+            case StorageFormat::DELTA: {
+                std::shared_ptr<const DeltaSparseMatrix<T> > delta = std::make_shared<const DeltaSparseMatrix<T> >(matrix);
+                return OptimizedOperator<T>(m, n, format, [delta] (const std::vector<T> & x) { return delta->multiply(x); });
+            }
+
+            case StorageFormat::DIAGONAL: {
+                std::shared_ptr<const DiagonalSparseMatrix<T> > diagonal = std::make_shared<const DiagonalSparseMatrix<T> >(matrix);
+                return OptimizedOperator<T>(m, n, format, [diagonal] (const std::vector<T> & x) { return diagonal->multiply(x); });
+            }
+
+            case StorageFormat::TILED: {
+                std::shared_ptr<const TiledSparseMatrix<T> > tiled = std::make_shared<const TiledSparseMatrix<T> >(matrix);
+                return OptimizedOperator<T>(m, n, format, [tiled] (const std::vector<T> & x) { return tiled->multiply(x); });
+            }
+
+            case StorageFormat::HYBRID: {
+                std::shared_ptr<const HybridSparseMatrix<T> > hybrid = std::make_shared<const HybridSparseMatrix<T> >(matrix);
+                return OptimizedOperator<T>(m, n, format, [hybrid] (const std::vector<T> & x) { return hybrid->multiply(x); });
+            }
+
+            default: {
+                std::shared_ptr<const SparseMatrix<T> > crs = std::make_shared<const SparseMatrix<T> >(matrix);
+                return OptimizedOperator<T>(m, n, StorageFormat::CRS, [crs] (const std::vector<T> & x) { return crs->multiply(x); });
+            }
+        }
+    }
+
+
+    template<typename T>
+    OptimizedOperator<T> AutoTuner<T>::tune(const SparseMatrix<T> & matrix, const Options & options)
+    {
+        StorageFormat format = StorageFormat::CRS;
+        uint64_t hash = 0;
+
+        if (!options.cacheFile.empty()) {
+            hash = fingerprint(matrix);
+
+            if (findCached(options.cacheFile, hash, format)) {
+                return create(matrix, format);
+            }
+        }
+
+        MatrixFeatures features = analyze(matrix);
+        format = options.benchmark ? benchmark(matrix, features, std::max<size_t>(options.repetitions, 1)) : choose(features);
+
+        if (!options.cacheFile.empty()) {
+            storeCached(options.cacheFile, hash, format);
+        }
+
+        return create(matrix, format);
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    bool AutoTuner<T>::findCached(const std::string & file, uint64_t fingerprint, StorageFormat & format)
+    {
+        std::ifstream input(file);
+        uint64_t key;
+        std::string name;
+
+        // one "fingerprint format" line per decision, the last one wins
+        bool found = false;
+
+        while (input >> key >> name) {
+            for (int f = 0; key == fingerprint && f <= static_cast<int>(StorageFormat::HYBRID); f++) {
+                if (name == getFormatName(static_cast<StorageFormat>(f))) {
+                    format = static_cast<StorageFormat>(f);
+                    found = true;
+                }
+            }
+        }
+
+        return found;
+    }
+
+
+    template<typename T>
+    void AutoTuner<T>::storeCached(const std::string & file, uint64_t fingerprint, StorageFormat format)
+    {
+        std::ofstream output(file, std::ios::app);
+
+        if (!(output << fingerprint << ' ' << getFormatName(format) << '\n')) {
+            throw SystemException("Cannot write tuning cache '" + file + "'.");
+        }
+    }
+
+
+    template<typename T>
+    StorageFormat AutoTuner<T>::benchmark(const SparseMatrix<T> & matrix, const MatrixFeatures & features, size_t repetitions)
+    {
+        std::vector<StorageFormat> candidates{ StorageFormat::CRS };
+
+        if (features.gapMax <= DeltaSparseMatrix<T>::MAX_GAP) {
+            candidates.push_back(StorageFormat::DELTA);
+        }
+
+        // DIA with a lot of padding can't win and could exhaust memory
+        if (features.diagonalFill <= 2 * static_cast<double>(sizeof(T) + sizeof(size_t)) / sizeof(T)) {
+            candidates.push_back(StorageFormat::DIAGONAL);
+        }
+
+        if (features.columns > TiledSparseMatrix<T>::DEFAULT_TILE_BYTES / sizeof(T)) {
+            candidates.push_back(StorageFormat::TILED);
+        }
+
+        if (features.rowMax > HybridSparseMatrix<T>::defaultThreshold(features.rows, features.nnz)) {
+            candidates.push_back(StorageFormat::HYBRID);
+        }
+
+        std::vector<T> x(features.columns, T(1));
+        StorageFormat best = StorageFormat::CRS;
+        std::chrono::steady_clock::duration bestTime = std::chrono::steady_clock::duration::max();
+
+        for (StorageFormat candidate : candidates) {
+            OptimizedOperator<T> op = create(matrix, candidate);
+
+            for (size_t r = 0; r < repetitions; r++) {
+                std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+                op.multiply(x);
+                std::chrono::steady_clock::duration time = std::chrono::steady_clock::now() - start;
+
+                if (time < bestTime) {
+                    bestTime = time;
+                    best = candidate;
+                }
+            }
+        }
+
+        return best;
+    }
+
+	}
+
+#endif
@@ -0,0 +1,678 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_CHOLESKYSOLVER_H__
+
+	#define	__SPARSEMATRIX_CHOLESKYSOLVER_H__
+
+	#include <cmath>
+	#include <limits>
+	#include <vector>
+	#include <utility>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Direct solver of symmetric systems by sparse LDLᵀ factorization (Cholesky without square roots).
+		 *
+		 * The matrix has to be symmetric with both triangles stored. The constructor
+		 * does the symbolic phase once per pattern - fill-reducing ordering, elimination
+		 * tree and column counts of L. factor() computes L and D for given values
+		 * (row by row, "up-looking") and can be called repeatedly, solve() then does
+		 * two triangular solves and a diagonal scaling.
+		 */
+		template<typename T>
+		class CholeskySolver
+		{
+
+			public:
+
+				enum Ordering
+				{
+					NATURAL,
+					MINIMUM_DEGREE // approximate minimum degree (AMD) on the quotient graph
+				};
+
+
+				// === CREATION ==============================================
+
+				explicit CholeskySolver(const SparseMatrix<T> & matrix, Ordering ordering = MINIMUM_DEGREE);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getFactorNnz(void) const; // strictly lower elements of L
+				const std::vector<size_t> & getPermutation(void) const; // row k of the factor is row permutation[k] of the matrix
+
+				bool isFactorized(void) const;
+				bool isPositiveDefinite(void) const; // all pivots positive
+
+
+				// === OPERATIONS ==============================================
+
+				void factor(const SparseMatrix<T> & matrix); // same pattern as analysed, new values
+				std::vector<T> solve(const std::vector<T> & b) const;
+
+
+			protected:
+
+				enum : size_t { NONE = static_cast<size_t>(-1) };
+
+				size_t n;
+				bool factorized;
+
+				// analysed pattern, factor() accepts only matrices with the same one
+				std::vector<size_t> patternRows, patternCols;
+
+				std::vector<size_t> permutation, inverse;
+				std::vector<size_t> parent; // elimination tree
+
+				// L by columns (unit diagonal not stored) and D
+				std::vector<size_t> lColumns, lRows;
+				std::vector<T> lVals, d;
+
+
+				void order(Ordering ordering);
+				void orderMinimumDegree(void);
+				void analyze(void);
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    CholeskySolver<T>::CholeskySolver(const SparseMatrix<T> & matrix, Ordering ordering)
+        : n(matrix.getRowCount()), factorized(false)
+    {
+        if (matrix.getRowCount() != matrix.getColumnCount()) {
+            throw InvalidDimensionsException("Cannot factorize: Matrix has to be square.");
+        }
+
+        this->patternRows = *(matrix.rows);
+
+        if (matrix.getNnz() != 0) {
+            this->patternCols = *(matrix.cols);
+        }
+
+        this->order(ordering);
+        this->analyze();
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t CholeskySolver<T>::getRowCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t CholeskySolver<T>::getFactorNnz(void) const
+    {
+        return this->lColumns[this->n];
+    }
+
+
+    template<typename T>
+    const std::vector<size_t> & CholeskySolver<T>::getPermutation(void) const
+    {
+        return this->permutation;
+    }
+
+
+    template<typename T>
+    bool CholeskySolver<T>::isFactorized(void) const
+    {
+        return this->factorized;
+    }
+
+
+    template<typename T>
+    bool CholeskySolver<T>::isPositiveDefinite(void) const
+    {
+        if (!this->factorized) {
+            throw InvalidArgumentException("Matrix is not factorized yet.");
+        }
+
+        for (size_t k = 0; k < this->n; k++) {
+            if (!(T() < this->d[k])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    void CholeskySolver<T>::factor(const SparseMatrix<T> & matrix)
+    {
+        if (matrix.getRowCount() != this->n || matrix.getColumnCount() != this->n) {
+            throw InvalidDimensionsException("Cannot factorize: Matrix dimensions don't match.");
+        }
+
+        if (*(matrix.rows) != this->patternRows || (matrix.getNnz() != 0 && *(matrix.cols) != this->patternCols)) {
+            throw InvalidArgumentException("Cannot factorize: Matrix pattern doesn't match the analysed one.");
+        }
+
+        this->factorized = false;
+
+        std::vector<T> y(this->n, T());
+        std::vector<size_t> flag(this->n), pattern(this->n), filled(this->n, 0);
+
+        this->d.assign(this->n, T());
+
+        // pivots this small compared to their column are rounding noise - dividing by them gives inf / NaN
+        const T tolerance = static_cast<T>(this->n) * std::numeric_limits<T>::epsilon();
+
+        // row k of L solves L(0:k, 0:k) D l = a(0:k, k), its pattern is a path in the elimination tree
+        for (size_t k = 0; k < this->n; k++) {
+            size_t top = this->n;
+            size_t row = this->permutation[k];
+            T magnitude = T();
+            flag[k] = k;
+
+            for (size_t pos = (*(matrix.rows))[row]; pos < (*(matrix.rows))[row + 1]; pos++) {
+                size_t i = this->inverse[(*(matrix.cols))[pos]];
+                const T & value = (*(matrix.vals))[pos];
+
+                magnitude = std::max(magnitude, value < T() ? -value : value);
+
+                if (i > k) {
+                    continue;
+                }
+
+                y[i] = y[i] + value;
+
+                size_t length = 0;
+                for (; flag[i] != k; i = this->parent[i]) {
+                    pattern[length++] = i;
+                    flag[i] = k;
+                }
+
+                while (length > 0) {
+                    pattern[--top] = pattern[--length];
+                }
+            }
+
+            this->d[k] = y[k];
+            y[k] = T();
+
+            for (; top < this->n; top++) {
+                size_t i = pattern[top];
+                T yi = y[i];
+                y[i] = T();
+
+                size_t end = this->lColumns[i] + filled[i];
+                for (size_t pos = this->lColumns[i]; pos < end; pos++) {
+                    y[this->lRows[pos]] = y[this->lRows[pos]] - this->lVals[pos] * yi;
+                }
+
+                T lki = yi / this->d[i];
+                this->d[k] = this->d[k] - lki * yi;
+
+                this->lRows[end] = k;
+                this->lVals[end] = lki;
+                filled[i]++;
+            }
+
+            if (!(tolerance * magnitude < (this->d[k] < T() ? -this->d[k] : this->d[k]))) {
+                throw InvalidArgumentException("Cannot factorize: Zero or tiny pivot, matrix is (nearly) singular.");
+            }
+        }
+
+        this->factorized = true;
+    }
+
+
+    template<typename T>
+    std::vector<T> CholeskySolver<T>::solve(const std::vector<T> & b) const
+    {
+        if (!this->factorized) {
+            throw InvalidArgumentException("Cannot solve: Matrix is not factorized yet.");
+        }
+
+        if (b.size() != this->n) {
+            throw InvalidDimensionsException("Cannot solve: Matrix row count and vector size don't match.");
+        }
+
+        std::vector<T> x(this->n);
+
+        for (size_t k = 0; k < this->n; k++) {
+            x[k] = b[this->permutation[k]];
+        }
+
+        // L y = Pb
+        for (size_t j = 0; j < this->n; j++) {
+            for (size_t pos = this->lColumns[j]; pos < this->lColumns[j + 1]; pos++) {
+                x[this->lRows[pos]] = x[this->lRows[pos]] - this->lVals[pos] * x[j];
+            }
+        }
+
+        // D z = y
+        for (size_t j = 0; j < this->n; j++) {
+            x[j] = x[j] / this->d[j];
+        }
+
+        // Lᵀ w = z
+        for (size_t j = this->n; j-- > 0; ) {
+            for (size_t pos = this->lColumns[j]; pos < this->lColumns[j + 1]; pos++) {
+                x[j] = x[j] - this->lVals[pos] * x[this->lRows[pos]];
+            }
+        }
+
+        std::vector<T> result(this->n);
+
+        for (size_t k = 0; k < this->n; k++) {
+            result[this->permutation[k]] = x[k];
+        }
+
+        return result;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void CholeskySolver<T>::order(Ordering ordering)
+    {
+        this->permutation.resize(this->n);
+
+        if (ordering == NATURAL) {
+            for (size_t k = 0; k < this->n; k++) {
+                this->permutation[k] = k;
+            }
+
+        } else {
+            this->orderMinimumDegree();
+        }
+
+        this->inverse.resize(this->n);
+
+        for (size_t k = 0; k < this->n; k++) {
+            this->inverse[this->permutation[k]] = k;
+        }
+    }
+
+
+    template<typename T>
+    void CholeskySolver<T>::orderMinimumDegree(void)
+    {
+        // Approximate minimum degree on the quotient graph (Amestoy, Davis, Duff). An eliminated node
+        // becomes an element standing for the clique of its variables, so the graph never grows.
+        // Elements covered by a newer one are absorbed, variables with the same adjacency are merged
+        // into supervariables, and degrees are upper bounds cheap to update instead of exact ones.
+
+        enum State : char { VARIABLE, ELEMENT, DEAD };
+
+        const size_t n = this->n;
+
+        std::vector<std::vector<size_t> > variables(n), elements(n); // adjacent variables / elements, variables of an element
+        std::vector<size_t> weight(n, 1); // original nodes of a supervariable, 0 when merged or eliminated
+        std::vector<size_t> degree(n); // approximate external degree of a variable, weighted size of an element
+        std::vector<char> state(n, VARIABLE);
+
+        // nodes ordered together with a principal variable
+        std::vector<size_t> nextMember(n, NONE), lastMember(n);
+
+        // variables by degree, doubly linked buckets
+        std::vector<size_t> head(n + 1, NONE), next(n, NONE), previous(n, NONE);
+        size_t minDegree = 0;
+
+        auto insert = [&] (size_t i) {
+            next[i] = head[degree[i]];
+            previous[i] = NONE;
+
+            if (head[degree[i]] != NONE) {
+                previous[head[degree[i]]] = i;
+            }
+
+            head[degree[i]] = i;
+            minDegree = std::min(minDegree, degree[i]);
+        };
+
+        auto remove = [&] (size_t i) {
+            if (previous[i] != NONE) {
+                next[previous[i]] = next[i];
+
+            } else {
+                head[degree[i]] = next[i];
+            }
+
+            if (next[i] != NONE) {
+                previous[next[i]] = previous[i];
+            }
+        };
+
+        auto append = [&] (size_t i, size_t j) {
+            nextMember[lastMember[i]] = j;
+            lastMember[i] = lastMember[j];
+        };
+
+        auto release = [] (std::vector<size_t> & list) {
+            std::vector<size_t>().swap(list);
+        };
+
+        // dense rows would be scanned in every step, they go last
+        std::vector<size_t> rowLength(n, 0);
+
+        for (size_t i = 0; i < n; i++) {
+            for (size_t pos = this->patternRows[i]; pos < this->patternRows[i + 1]; pos++) {
+                if (this->patternCols[pos] != i) {
+                    rowLength[i]++;
+                    rowLength[this->patternCols[pos]]++;
+                }
+            }
+        }
+
+        const size_t denseLimit = std::max<size_t>(16, static_cast<size_t>(10 * std::sqrt(static_cast<double>(n))));
+        std::vector<size_t> dense;
+        size_t eliminated = 0;
+
+        for (size_t i = 0; i < n; i++) {
+            lastMember[i] = i;
+
+            if (rowLength[i] > denseLimit) {
+                dense.push_back(i);
+                state[i] = DEAD;
+                weight[i] = 0;
+                eliminated++;
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            for (size_t pos = this->patternRows[i]; pos < this->patternRows[i + 1]; pos++) {
+                size_t j = this->patternCols[pos];
+
+                if (i != j && state[i] == VARIABLE && state[j] == VARIABLE) {
+                    variables[i].push_back(j);
+                    variables[j].push_back(i);
+                }
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            if (state[i] == VARIABLE) {
+                std::sort(variables[i].begin(), variables[i].end());
+                variables[i].erase(std::unique(variables[i].begin(), variables[i].end()), variables[i].end());
+
+                degree[i] = variables[i].size();
+                insert(i);
+            }
+        }
+
+        std::vector<size_t> mark(n, 0), seen(n, 0), outside(n, 0), outsideMark(n, 0), external(n, 0);
+        size_t stamp = 0, seenStamp = 0, k = 0;
+
+        std::vector<size_t> pivotVariables;
+        std::vector<std::pair<size_t, size_t> > hashes;
+
+        while (eliminated < n) {
+            while (head[minDegree] == NONE) {
+                minDegree++;
+            }
+
+            size_t p = head[minDegree];
+            remove(p);
+
+            // variables of the new element - neighbours of p and variables of the elements it absorbs
+            stamp++;
+            mark[p] = stamp;
+            pivotVariables.clear();
+            size_t pivotWeight = 0;
+
+            auto collect = [&] (size_t i) {
+                if (state[i] == VARIABLE && mark[i] != stamp) {
+                    mark[i] = stamp;
+                    pivotVariables.push_back(i);
+                    pivotWeight += weight[i];
+                }
+            };
+
+            for (size_t e : elements[p]) {
+                if (state[e] == ELEMENT) {
+                    for (size_t i : variables[e]) {
+                        collect(i);
+                    }
+
+                    state[e] = DEAD;
+                    release(variables[e]);
+                }
+            }
+
+            for (size_t i : variables[p]) {
+                collect(i);
+            }
+
+            release(elements[p]);
+            release(variables[p]);
+            state[p] = ELEMENT;
+            eliminated += weight[p];
+
+            for (size_t i : pivotVariables) {
+                remove(i);
+            }
+
+            // |Le \ Lp| of every element next to the new one
+            for (size_t i : pivotVariables) {
+                for (size_t e : elements[i]) {
+                    if (state[e] == ELEMENT) {
+                        if (outsideMark[e] != stamp) {
+                            outsideMark[e] = stamp;
+                            outside[e] = degree[e];
+                        }
+
+                        outside[e] -= weight[i];
+                    }
+                }
+            }
+
+            // prune adjacency of the variables and bound their external degrees
+            for (size_t i : pivotVariables) {
+                size_t kept = 0, degreeOutside = 0;
+
+                for (size_t e : elements[i]) {
+                    if (state[e] != ELEMENT) {
+                        continue;
+                    }
+
+                    if (outside[e] == 0) { // Le is a subset of Lp - aggressive absorption
+                        state[e] = DEAD;
+                        release(variables[e]);
+                        continue;
+                    }
+
+                    degreeOutside += outside[e];
+                    elements[i][kept++] = e;
+                }
+
+                elements[i].resize(kept);
+                elements[i].push_back(p);
+                kept = 0;
+
+                for (size_t j : variables[i]) {
+                    // edges within Lp are covered by the new element
+                    if (state[j] == VARIABLE && mark[j] != stamp) {
+                        degreeOutside += weight[j];
+                        variables[i][kept++] = j;
+                    }
+                }
+
+                variables[i].resize(kept);
+                external[i] = degreeOutside;
+
+                // adjacent to nothing but the new element - eliminated together with p
+                if (degreeOutside == 0) {
+                    append(p, i);
+                    eliminated += weight[i];
+                    pivotWeight -= weight[i];
+                    weight[i] = 0;
+                    state[i] = DEAD;
+                    release(elements[i]);
+                    release(variables[i]);
+                }
+            }
+
+            // supervariables - variables with the same adjacency are merged, candidates share a hash
+            hashes.clear();
+
+            for (size_t i : pivotVariables) {
+                if (state[i] == VARIABLE) {
+                    size_t hash = 0;
+
+                    for (size_t e : elements[i]) {
+                        hash += e;
+                    }
+
+                    for (size_t j : variables[i]) {
+                        hash += j;
+                    }
+
+                    hashes.push_back(std::make_pair(hash, i));
+                }
+            }
+
+            std::sort(hashes.begin(), hashes.end());
+
+            for (size_t a = 0; a < hashes.size(); a++) {
+                size_t i = hashes[a].second;
+
+                if (state[i] != VARIABLE) {
+                    continue;
+                }
+
+                bool marked = false;
+
+                for (size_t b = a + 1; b < hashes.size() && hashes[b].first == hashes[a].first; b++) {
+                    size_t j = hashes[b].second;
+
+                    if (state[j] != VARIABLE || elements[i].size() != elements[j].size() || variables[i].size() != variables[j].size()) {
+                        continue;
+                    }
+
+                    if (!marked) {
+                        seenStamp++;
+
+                        for (size_t e : elements[i]) {
+                            seen[e] = seenStamp;
+                        }
+
+                        for (size_t v : variables[i]) {
+                            seen[v] = seenStamp;
+                        }
+
+                        marked = true;
+                    }
+
+                    bool same = true;
+
+                    for (size_t e : elements[j]) {
+                        same = same && seen[e] == seenStamp;
+                    }
+
+                    for (size_t v : variables[j]) {
+                        same = same && seen[v] == seenStamp;
+                    }
+
+                    if (same) {
+                        append(i, j);
+                        weight[i] += weight[j];
+                        weight[j] = 0;
+                        state[j] = DEAD;
+                        release(elements[j]);
+                        release(variables[j]);
+                    }
+                }
+            }
+
+            // approximate degrees - min of the remaining count, the previous degree and the external bound
+            size_t kept = 0;
+
+            for (size_t i : pivotVariables) {
+                if (state[i] != VARIABLE) {
+                    continue;
+                }
+
+                size_t others = pivotWeight - weight[i];
+                degree[i] = std::min(n - eliminated - weight[i], std::min(degree[i] + others, external[i] + others));
+                insert(i);
+
+                pivotVariables[kept++] = i;
+            }
+
+            pivotVariables.resize(kept);
+
+            if (pivotVariables.empty()) {
+                state[p] = DEAD;
+
+            } else {
+                degree[p] = pivotWeight;
+                variables[p] = pivotVariables;
+            }
+
+            for (size_t i = p; i != NONE; i = nextMember[i]) {
+                this->permutation[k++] = i;
+            }
+        }
+
+        for (size_t i : dense) {
+            this->permutation[k++] = i;
+        }
+    }
+
+
+    template<typename T>
+    void CholeskySolver<T>::analyze(void)
+    {
+        this->parent.assign(this->n, NONE);
+
+        std::vector<size_t> flag(this->n), counts(this->n, 0);
+
+        // walk from every element of row k up the elimination tree, each visited column gets element in row k
+        for (size_t k = 0; k < this->n; k++) {
+            size_t row = this->permutation[k];
+            flag[k] = k;
+
+            for (size_t pos = this->patternRows[row]; pos < this->patternRows[row + 1]; pos++) {
+                size_t i = this->inverse[this->patternCols[pos]];
+
+                for (; i < k && flag[i] != k; i = this->parent[i]) {
+                    if (this->parent[i] == NONE) {
+                        this->parent[i] = k;
+                    }
+
+                    counts[i]++;
+                    flag[i] = k;
+                }
+            }
+        }
+
+        this->lColumns.assign(this->n + 1, 0);
+
+        for (size_t k = 0; k < this->n; k++) {
+            this->lColumns[k + 1] = this->lColumns[k] + counts[k];
+        }
+
+        this->lRows.resize(this->lColumns[this->n]);
+        this->lVals.resize(this->lColumns[this->n]);
+    }
+
+	}
+
+#endif
@@ -0,0 +1,240 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_COLUMNSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_COLUMNSPARSEMATRIX_H__
+
+	#include <vector>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "semirings.h"
+	#include "accumulator.h"
+	#include "SparseMatrix.h"
+	#include "SparseVector.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Read-only copy of a SparseMatrix in the CCS (compressed column) format.
+		 *
+		 * Multiplication by a SparseVector visits only the columns selected by
+		 * non-zero elements of the vector and sums them in a sparse accumulator, so
+		 * its cost depends on the number of touched elements, not on the matrix size.
+		 * Meant for very sparse vectors, such as frontiers of graph traversals.
+		 */
+		template<typename T>
+		class ColumnSparseMatrix
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				explicit ColumnSparseMatrix(const SparseMatrix<T> & matrix);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SparseMatrix<T> toMatrix(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				SparseVector<T> multiply(const SparseVector<T> & x) const;
+				SparseVector<T> operator * (const SparseVector<T> & x) const;
+
+				template<typename S>
+				SparseVector<T> multiply(const SparseVector<T> & x) const; // over semiring S
+
+				template<typename S = PlusTimes<T>, typename X = T>
+				SparseVector<T> multiplyMasked(const SparseVector<T> & x, const SparseVector<X> & mask, bool complement = false) const; // only elements in (or out of) mask
+
+
+			protected:
+
+				size_t m, n;
+
+				std::vector<size_t> cols; // column pointers into rows and vals
+				std::vector<size_t> rows; // row of every element, ascending within a column
+				std::vector<T> vals;
+
+
+				template<typename S, typename F>
+				SparseVector<T> multiply(const SparseVector<T> & x, F keep) const; // keep(row) filters result elements
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    ColumnSparseMatrix<T>::ColumnSparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n)
+    {
+        // columns of the matrix are rows of its transposition
+        matrix.transposeInto(this->cols, this->rows, this->vals);
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t ColumnSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t ColumnSparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t ColumnSparseMatrix<T>::getNnz(void) const
+    {
+        return this->vals.size();
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    T ColumnSparseMatrix<T>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        std::vector<size_t>::const_iterator first = this->rows.begin() + this->cols[col];
+        std::vector<size_t>::const_iterator last = this->rows.begin() + this->cols[col + 1];
+        std::vector<size_t>::const_iterator it = std::lower_bound(first, last, row);
+
+        if (it == last || *it != row) {
+            return T();
+        }
+
+        return this->vals[it - this->rows.begin()];
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> ColumnSparseMatrix<T>::toMatrix(void) const
+    {
+        // stored arrays are the CRS format of the transposition
+        SparseMatrix<T> transposed(this->n, this->m);
+        transposed.assign(std::vector<size_t>(this->cols), std::vector<size_t>(this->rows), std::vector<T>(this->vals));
+
+        return transposed.transpose();
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    SparseVector<T> ColumnSparseMatrix<T>::multiply(const SparseVector<T> & x) const
+    {
+        return this->template multiply<PlusTimes<T> >(x);
+    }
+
+
+    template<typename T>
+    SparseVector<T> ColumnSparseMatrix<T>::operator * (const SparseVector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T>
+    template<typename S>
+    SparseVector<T> ColumnSparseMatrix<T>::multiply(const SparseVector<T> & x) const
+    {
+        return this->template multiply<S>(x, [] (size_t) {
+            return true;
+        });
+    }
+
+
+    template<typename T>
+    template<typename S, typename X>
+    SparseVector<T> ColumnSparseMatrix<T>::multiplyMasked(const SparseVector<T> & x, const SparseVector<X> & mask, bool complement) const
+    {
+        if (mask.getSize() != this->m) {
+            throw InvalidDimensionsException("Cannot multiply: Mask size and matrix row count don't match.");
+        }
+
+        // mask is tested once per touched element - enableBitmap() on the mask makes it O(1)
+        return this->template multiply<S>(x, [&mask, complement] (size_t row) {
+            return mask.contains(row) != complement;
+        });
+    }
+
+
+    template<typename T>
+    template<typename S, typename F>
+    SparseVector<T> ColumnSparseMatrix<T>::multiply(const SparseVector<T> & x, F keep) const
+    {
+        if (this->n != x.getSize()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        // missing elements of x have to mean the same as missing elements of the result
+        if (!(x.getZero() == S::zero())) {
+            throw InvalidArgumentException("Cannot multiply: Vector zero and semiring zero don't match.");
+        }
+
+        const std::vector<size_t> & indices = x.getIndices();
+        const std::vector<T> & values = x.getValues();
+
+        size_t flops = 0;
+
+        for (size_t j : indices) {
+            flops += this->cols[j + 1] - this->cols[j];
+        }
+
+        // used once, so the dense variant only pays off when its m-sized arrays are comparable to the work
+        SparseAccumulator<T, S> accumulator(this->m, flops, 0);
+
+        for (size_t k = 0; k < indices.size(); k++) {
+            size_t j = indices[k];
+
+            for (size_t pos = this->cols[j]; pos < this->cols[j + 1]; pos++) {
+                size_t row = this->rows[pos];
+
+                if (keep(row)) {
+                    accumulator.accumulate(row, S::multiply(this->vals[pos], values[k]));
+                }
+            }
+        }
+
+        std::vector<size_t> resultIndices(accumulator.size());
+        std::vector<T> resultValues(accumulator.size());
+
+        size_t count = accumulator.gather(resultIndices.data(), resultValues.data());
+        resultIndices.resize(count);
+        resultValues.resize(count);
+
+        return SparseVector<T>(this->m, std::move(resultIndices), std::move(resultValues), S::zero());
+    }
+
+	}
+
+#endif
@@ -0,0 +1,255 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_COMPACTSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_COMPACTSPARSEMATRIX_H__
+
+	#include <cmath>
+	#include <vector>
+	#include "exceptions.h"
+	#include "precision.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Read-only copy of a SparseMatrix with values stored in a narrower type.
+		 *
+		 * V is the storage type (float, Half, BFloat16 or row-scaled int8_t),
+		 * A is the type the values are decoded to and accumulated in. Vector
+		 * multiplication reads less memory per element, which is what limits it.
+		 */
+		template<typename V, typename A = double>
+		class CompactSparseMatrix
+		{
+
+			public:
+
+				typedef typename SparseMatrix<A>::MemoryUsage MemoryUsage;
+
+
+				// === CREATION ==============================================
+
+				template<typename T>
+				explicit CompactSparseMatrix(const SparseMatrix<T> & matrix);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+
+
+				// === VALUES ==============================================
+
+				A get(size_t row, size_t col) const; // decoded value
+				SparseMatrix<A> toMatrix(void) const; // decoded copy, values rounded to zero are dropped
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<A> multiply(const std::vector<A> & x) const;
+				std::vector<A> operator * (const std::vector<A> & x) const;
+
+
+				// === CAPACITY ==============================================
+
+				MemoryUsage memoryUsage(void) const; // row scales are counted as values
+
+
+			protected:
+
+				typedef ValueStorage<V> Storage;
+
+				size_t m, n;
+
+				std::vector<size_t> rows, cols;
+				std::vector<V> vals;
+				std::vector<A> scales; // per row, only for scaled storage types
+
+
+				A decode(size_t row, size_t pos) const;
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename V, typename A>
+    template<typename T>
+    CompactSparseMatrix<V, A>::CompactSparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n), rows(*(matrix.rows))
+    {
+        if (Storage::SCALED) {
+            this->scales.assign(this->m, A(1));
+        }
+
+        if (matrix.vals == nullptr) {
+            return ;
+        }
+
+        this->cols = *(matrix.cols);
+        this->vals.reserve(matrix.vals->size());
+
+        for (size_t i = 0; i < this->m; i++) {
+            double largest = 0.0;
+
+            if (Storage::SCALED) {
+                for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                    largest = std::max(largest, std::abs(static_cast<double>((*(matrix.vals))[pos])));
+                }
+
+                this->scales[i] = static_cast<A>(Storage::scale(largest));
+            }
+
+            double scale = Storage::scale(largest);
+
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                this->vals.push_back(Storage::encode(static_cast<double>((*(matrix.vals))[pos]) / scale));
+            }
+        }
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename V, typename A>
+    size_t CompactSparseMatrix<V, A>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename V, typename A>
+    size_t CompactSparseMatrix<V, A>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename V, typename A>
+    size_t CompactSparseMatrix<V, A>::getNnz(void) const
+    {
+        return this->vals.size();
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename V, typename A>
+    A CompactSparseMatrix<V, A>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        std::vector<size_t>::const_iterator end = this->cols.begin() + this->rows[row + 1];
+        std::vector<size_t>::const_iterator pos = std::lower_bound(this->cols.begin() + this->rows[row], end, col);
+
+        return (pos != end && *pos == col) ? this->decode(row, pos - this->cols.begin()) : A();
+    }
+
+
+    template<typename V, typename A>
+    SparseMatrix<A> CompactSparseMatrix<V, A>::toMatrix(void) const
+    {
+        SparseMatrix<A> result(this->m, this->n);
+
+        std::vector<size_t> rows(this->m + 1, 0);
+        std::vector<size_t> cols;
+        std::vector<A> vals;
+
+        cols.reserve(this->vals.size());
+        vals.reserve(this->vals.size());
+
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                A val = this->decode(i, pos);
+
+                if (!(val == A())) {
+                    cols.push_back(this->cols[pos]);
+                    vals.push_back(val);
+                }
+            }
+
+            rows[i + 1] = vals.size();
+        }
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename V, typename A>
+    std::vector<A> CompactSparseMatrix<V, A>::multiply(const std::vector<A> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<A> result(this->m, A());
+
+        Parallel::parallelFor(this->rows, [&] (size_t firstRow, size_t lastRow) {
+            const size_t * colIdx = this->cols.data();
+            const V * values = this->vals.data();
+
+            for (size_t i = firstRow; i < lastRow; i++) {
+                A sum = A();
+                for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                    sum += Storage::template decode<A>(values[pos]) * x[colIdx[pos]];
+                }
+
+                result[i] = Storage::SCALED ? sum * this->scales[i] : sum;
+            }
+        });
+
+        return result;
+    }
+
+
+    template<typename V, typename A>
+    std::vector<A> CompactSparseMatrix<V, A>::operator * (const std::vector<A> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    // === CAPACITY ==============================================
+
+    template<typename V, typename A>
+    typename CompactSparseMatrix<V, A>::MemoryUsage CompactSparseMatrix<V, A>::memoryUsage(void) const
+    {
+        MemoryUsage usage;
+
+        usage.rows = this->rows.capacity() * sizeof(size_t);
+        usage.cols = this->cols.capacity() * sizeof(size_t);
+        usage.vals = this->vals.capacity() * sizeof(V) + this->scales.capacity() * sizeof(A);
+        usage.total = sizeof(*this) + usage.rows + usage.cols + usage.vals;
+
+        return usage;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename V, typename A>
+    A CompactSparseMatrix<V, A>::decode(size_t row, size_t pos) const
+    {
+        A val = Storage::template decode<A>(this->vals[pos]);
+        return Storage::SCALED ? val * this->scales[row] : val;
+    }
+
+	}
+
+#endif
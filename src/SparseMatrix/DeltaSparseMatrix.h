@@ -0,0 +1,343 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_DELTASPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_DELTASPARSEMATRIX_H__
+
+	#include <vector>
+	#include <cstdint>
+	#include "exceptions.h"
+	#include "parallel.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Read-only copy of a SparseMatrix with compressed column indices (CSR-DU).
+		 *
+		 * Every row stores its first column as a varint followed by gaps between
+		 * consecutive columns. Gaps are packed in units of up to 64 values of the same
+		 * width (1, 2 or 4 bytes) with one header byte, so rows with close columns
+		 * need about a byte per index instead of sizeof(size_t). Multiplication decodes
+		 * the indices on the fly - it trades a few instructions for less memory traffic.
+		 */
+		template<typename T>
+		class DeltaSparseMatrix
+		{
+
+			public:
+
+				static const size_t MAX_GAP = UINT32_MAX; // widest gap between neighbouring columns of a row
+
+
+				// === CREATION ==============================================
+
+				explicit DeltaSparseMatrix(const SparseMatrix<T> & matrix);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+				size_t getIndexBytes(void) const; // size of the compressed index stream
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SparseMatrix<T> toMatrix(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x) const;
+				std::vector<T> operator * (const std::vector<T> & x) const;
+
+				template<typename S>
+				std::vector<T> multiply(const std::vector<T> & x) const; // over semiring S
+
+
+			protected:
+
+				// unit header - width code in the top two bits, count - 1 in the rest
+				static const size_t UNIT_LENGTH = 64;
+
+
+				size_t m, n;
+
+				std::vector<size_t> rows; // CRS row pointers into vals
+				std::vector<size_t> offsets; // start of every row in the index stream
+				std::vector<uint8_t> indices;
+				std::vector<T> vals;
+
+
+				static unsigned widthCode(size_t gap); // 0, 1, 2 for 1, 2, 4 bytes
+
+				template<typename F>
+				void decodeRow(size_t row, F f) const; // f(position, column) for every element
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    DeltaSparseMatrix<T>::DeltaSparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n)
+    {
+        size_t nnz = matrix.getNnz();
+
+        // first columns are varints of any size, only the gaps are limited
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t pos = (*(matrix.rows))[i] + 1; pos < (*(matrix.rows))[i + 1]; pos++) {
+                if ((*(matrix.cols))[pos] - (*(matrix.cols))[pos - 1] > MAX_GAP) {
+                    throw InvalidArgumentException("Cannot compress: Column gaps have to fit into 32 bits.");
+                }
+            }
+        }
+
+        this->rows = *(matrix.rows);
+        this->offsets.reserve(this->m + 1);
+        this->indices.reserve(nnz + this->m * 2);
+
+        if (nnz != 0) {
+            this->vals = *(matrix.vals);
+        }
+
+        for (size_t i = 0; i < this->m; i++) {
+            this->offsets.push_back(this->indices.size());
+
+            size_t begin = this->rows[i], end = this->rows[i + 1];
+
+            if (begin == end) {
+                continue;
+            }
+
+            // first column as LEB128 varint
+            size_t first = (*(matrix.cols))[begin];
+
+            do {
+                this->indices.push_back(static_cast<uint8_t>((first & 0x7F) | (first >= 0x80 ? 0x80 : 0)));
+                first >>= 7;
+            } while (first != 0);
+
+            // gaps split into units of equal width
+            size_t pos = begin + 1;
+
+            while (pos < end) {
+                unsigned code = widthCode((*(matrix.cols))[pos] - (*(matrix.cols))[pos - 1]);
+                size_t count = 1;
+
+                while (pos + count < end && count < UNIT_LENGTH && widthCode((*(matrix.cols))[pos + count] - (*(matrix.cols))[pos + count - 1]) == code) {
+                    count++;
+                }
+
+                this->indices.push_back(static_cast<uint8_t>((code << 6) | (count - 1)));
+
+                for (size_t k = pos; k < pos + count; k++) {
+                    size_t gap = (*(matrix.cols))[k] - (*(matrix.cols))[k - 1];
+
+                    for (unsigned b = 0; b < (1u << code); b++) { // little-endian
+                        this->indices.push_back(static_cast<uint8_t>(gap >> (8 * b)));
+                    }
+                }
+
+                pos += count;
+            }
+        }
+
+        this->offsets.push_back(this->indices.size());
+        this->indices.shrink_to_fit();
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t DeltaSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t DeltaSparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t DeltaSparseMatrix<T>::getNnz(void) const
+    {
+        return this->vals.size();
+    }
+
+
+    template<typename T>
+    size_t DeltaSparseMatrix<T>::getIndexBytes(void) const
+    {
+        return this->indices.size();
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    T DeltaSparseMatrix<T>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        T result = T();
+
+        this->decodeRow(row, [&] (size_t pos, size_t column) {
+            if (column == col) {
+                result = this->vals[pos];
+            }
+        });
+
+        return result;
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> DeltaSparseMatrix<T>::toMatrix(void) const
+    {
+        SparseMatrix<T> result(this->m, this->n);
+
+        std::vector<size_t> cols(this->vals.size());
+
+        for (size_t i = 0; i < this->m; i++) {
+            this->decodeRow(i, [&] (size_t pos, size_t column) {
+                cols[pos] = column;
+            });
+        }
+
+        result.assign(std::vector<size_t>(this->rows), std::move(cols), std::vector<T>(this->vals));
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> DeltaSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        return this->template multiply<PlusTimes<T> >(x);
+    }
+
+
+    template<typename T>
+    std::vector<T> DeltaSparseMatrix<T>::operator * (const std::vector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T>
+    template<typename S>
+    std::vector<T> DeltaSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<T> result(this->m, S::zero());
+
+        Parallel::parallelFor(this->rows, [&] (size_t firstRow, size_t lastRow) {
+            const T * values = this->vals.data();
+            const T * input = x.data();
+
+            for (size_t i = firstRow; i < lastRow; i++) {
+                T sum = S::zero();
+
+                this->decodeRow(i, [&] (size_t pos, size_t column) {
+                    sum = S::add(sum, S::multiply(values[pos], input[column]));
+                });
+
+                result[i] = sum;
+            }
+        });
+
+        return result;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    unsigned DeltaSparseMatrix<T>::widthCode(size_t gap)
+    {
+        return gap <= UINT8_MAX ? 0 : (gap <= UINT16_MAX ? 1 : 2);
+    }
+
+
+    template<typename T>
+    template<typename F>
+    void DeltaSparseMatrix<T>::decodeRow(size_t row, F f) const
+    {
+        size_t pos = this->rows[row], end = this->rows[row + 1];
+
+        if (pos == end) {
+            return ;
+        }
+
+        const uint8_t * stream = this->indices.data() + this->offsets[row];
+        size_t col = 0;
+
+        for (unsigned shift = 0; ; shift += 7) {
+            col |= static_cast<size_t>(*stream & 0x7F) << shift;
+
+            if (!(*stream++ & 0x80)) {
+                break;
+            }
+        }
+
+        f(pos++, col);
+
+        // one switch per unit, the inner loops have fixed width
+        while (pos < end) {
+            uint8_t header = *stream++;
+            size_t count = (header & (UNIT_LENGTH - 1)) + 1;
+
+            switch (header >> 6) {
+                case 0:
+                    for (size_t k = 0; k < count; k++) {
+                        col += stream[k];
+                        f(pos++, col);
+                    }
+
+                    stream += count;
+                    break;
+
+                case 1:
+                    for (size_t k = 0; k < count; k++, stream += 2) {
+                        col += static_cast<size_t>(stream[0]) | static_cast<size_t>(stream[1]) << 8;
+                        f(pos++, col);
+                    }
+
+                    break;
+
+                default:
+                    for (size_t k = 0; k < count; k++, stream += 4) {
+                        col += static_cast<size_t>(stream[0]) | static_cast<size_t>(stream[1]) << 8 | static_cast<size_t>(stream[2]) << 16 | static_cast<size_t>(stream[3]) << 24;
+                        f(pos++, col);
+                    }
+            }
+        }
+    }
+
+	}
+
+#endif
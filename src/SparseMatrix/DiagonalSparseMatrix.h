@@ -0,0 +1,337 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_DIAGONALSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_DIAGONALSPARSEMATRIX_H__
+
+	#include <vector>
+	#include <algorithm>
+	#include <cstddef>
+	#include "exceptions.h"
+	#include "parallel.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Copy of a SparseMatrix in the DIA format - every diagonal holding a non-zero
+		 * element is stored as a contiguous array, zeros included.
+		 *
+		 * No column indices are stored and multiplication walks x with unit stride, so
+		 * it vectorizes. This pays off for banded matrices (stencils), fillRatio() tells
+		 * how many elements would be stored per non-zero one.
+		 */
+		template<typename T>
+		class DiagonalSparseMatrix
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				explicit DiagonalSparseMatrix(const SparseMatrix<T> & matrix);
+
+
+				// === DETECTION ==============================================
+
+				static double fillRatio(const SparseMatrix<T> & matrix); // stored elements per non-zero element, 1 for empty matrix
+
+				// default threshold - DIA takes no more memory than CRS
+				static bool isSuitable(const SparseMatrix<T> & matrix, double maxFillRatio = static_cast<double>(sizeof(T) + sizeof(size_t)) / sizeof(T));
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getDiagonalCount(void) const;
+				size_t getStoredCount(void) const; // elements including zeros on stored diagonals
+				const std::vector<std::ptrdiff_t> & getOffsets(void) const; // column - row of every diagonal, ascending
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SparseMatrix<T> toMatrix(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x) const;
+				std::vector<T> operator * (const std::vector<T> & x) const;
+
+
+			protected:
+
+				size_t m, n;
+
+				std::vector<std::ptrdiff_t> offsets;
+				std::vector<size_t> starts; // diagonal d is vals[starts[d]] ... vals[starts[d + 1] - 1], from its first row
+				std::vector<T> vals;
+
+
+				size_t firstRow(std::ptrdiff_t offset) const;
+				size_t lastRow(std::ptrdiff_t offset) const; // exclusive
+
+				static std::vector<bool> occupied(const SparseMatrix<T> & matrix); // by offset + m - 1
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    DiagonalSparseMatrix<T>::DiagonalSparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n)
+    {
+        std::vector<bool> diagonals = occupied(matrix);
+        std::vector<size_t> index(diagonals.size(), 0); // diagonal number by offset + m - 1
+
+        this->starts.push_back(0);
+
+        for (size_t k = 0; k < diagonals.size(); k++) {
+            if (diagonals[k]) {
+                std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(k) - static_cast<std::ptrdiff_t>(this->m) + 1;
+
+                index[k] = this->offsets.size();
+                this->offsets.push_back(offset);
+                this->starts.push_back(this->starts.back() + this->lastRow(offset) - this->firstRow(offset));
+            }
+        }
+
+        this->vals.assign(this->starts.back(), T());
+
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                size_t k = (*(matrix.cols))[pos] + this->m - 1 - i;
+                size_t d = index[k];
+
+                this->vals[this->starts[d] + i - this->firstRow(this->offsets[d])] = (*(matrix.vals))[pos];
+            }
+        }
+    }
+
+
+    // === DETECTION ==============================================
+
+    template<typename T>
+    double DiagonalSparseMatrix<T>::fillRatio(const SparseMatrix<T> & matrix)
+    {
+        size_t nnz = matrix.getNnz();
+
+        if (nnz == 0) {
+            return 1.0;
+        }
+
+        std::vector<bool> diagonals = occupied(matrix);
+        size_t stored = 0;
+
+        for (size_t k = 0; k < diagonals.size(); k++) {
+            if (diagonals[k]) {
+                // rows max(0, -offset) ... min(m, n - offset) - 1
+                std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(k) - static_cast<std::ptrdiff_t>(matrix.m) + 1;
+                std::ptrdiff_t first = std::max<std::ptrdiff_t>(0, -offset);
+                std::ptrdiff_t last = std::min<std::ptrdiff_t>(matrix.m, static_cast<std::ptrdiff_t>(matrix.n) - offset);
+
+                stored += last - first;
+            }
+        }
+
+        return static_cast<double>(stored) / nnz;
+    }
+
+
+    template<typename T>
+    bool DiagonalSparseMatrix<T>::isSuitable(const SparseMatrix<T> & matrix, double maxFillRatio)
+    {
+        return fillRatio(matrix) <= maxFillRatio;
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::getDiagonalCount(void) const
+    {
+        return this->offsets.size();
+    }
+
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::getStoredCount(void) const
+    {
+        return this->vals.size();
+    }
+
+
+    template<typename T>
+    const std::vector<std::ptrdiff_t> & DiagonalSparseMatrix<T>::getOffsets(void) const
+    {
+        return this->offsets;
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    T DiagonalSparseMatrix<T>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(col) - static_cast<std::ptrdiff_t>(row);
+        std::vector<std::ptrdiff_t>::const_iterator it = std::lower_bound(this->offsets.begin(), this->offsets.end(), offset);
+
+        if (it == this->offsets.end() || *it != offset) {
+            return T();
+        }
+
+        size_t d = it - this->offsets.begin();
+        return this->vals[this->starts[d] + row - this->firstRow(offset)];
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> DiagonalSparseMatrix<T>::toMatrix(void) const
+    {
+        SparseMatrix<T> result(this->m, this->n);
+
+        std::vector<size_t> rows(this->m + 1, 0), cols;
+        std::vector<T> vals;
+
+        cols.reserve(this->vals.size());
+        vals.reserve(this->vals.size());
+
+        // diagonals are sorted by offset, so every row gets its columns in order
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t d = 0; d < this->offsets.size(); d++) {
+                std::ptrdiff_t offset = this->offsets[d];
+
+                if (i < this->firstRow(offset) || i >= this->lastRow(offset)) {
+                    continue;
+                }
+
+                const T & val = this->vals[this->starts[d] + i - this->firstRow(offset)];
+
+                if (!(val == T())) {
+                    cols.push_back(i + offset);
+                    vals.push_back(val);
+                }
+            }
+
+            rows[i + 1] = cols.size();
+        }
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> DiagonalSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<T> result(this->m, T());
+
+        // rows cost the same, so they are split evenly
+        size_t parts = this->vals.size() < Parallel::MINIMUM_WORK ? 1 : std::min(Parallel::getThreadCount(), std::max<size_t>(this->m, 1));
+        std::vector<size_t> bounds(parts + 1);
+
+        for (size_t p = 0; p <= parts; p++) {
+            bounds[p] = this->m * p / parts;
+        }
+
+        Parallel::run(bounds, [&] (size_t, size_t begin, size_t end) {
+            T * y = result.data();
+
+            for (size_t d = 0; d < this->offsets.size(); d++) {
+                std::ptrdiff_t offset = this->offsets[d];
+                size_t first = std::max(begin, this->firstRow(offset)), last = std::min(end, this->lastRow(offset));
+
+                if (first >= last) {
+                    continue;
+                }
+
+                // unit stride in all three arrays
+                const T * diagonal = this->vals.data() + this->starts[d] + first - this->firstRow(offset);
+                const T * input = x.data() + (first + offset);
+                T * output = y + first;
+
+                for (size_t k = 0; k < last - first; k++) {
+                    output[k] = output[k] + diagonal[k] * input[k];
+                }
+            }
+        });
+
+        return result;
+    }
+
+
+    template<typename T>
+    std::vector<T> DiagonalSparseMatrix<T>::operator * (const std::vector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::firstRow(std::ptrdiff_t offset) const
+    {
+        return offset < 0 ? static_cast<size_t>(-offset) : 0;
+    }
+
+
+    template<typename T>
+    size_t DiagonalSparseMatrix<T>::lastRow(std::ptrdiff_t offset) const
+    {
+        return std::min<std::ptrdiff_t>(this->m, static_cast<std::ptrdiff_t>(this->n) - offset);
+    }
+
+
+    template<typename T>
+    std::vector<bool> DiagonalSparseMatrix<T>::occupied(const SparseMatrix<T> & matrix)
+    {
+        std::vector<bool> diagonals(matrix.m + matrix.n == 0 ? 0 : matrix.m + matrix.n - 1, false);
+
+        for (size_t i = 0; i < matrix.m; i++) {
+            for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                diagonals[(*(matrix.cols))[pos] + matrix.m - 1 - i] = true;
+            }
+        }
+
+        return diagonals;
+    }
+
+	}
+
+#endif
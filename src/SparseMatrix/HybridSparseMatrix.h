@@ -0,0 +1,362 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_HYBRIDSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_HYBRIDSPARSEMATRIX_H__
+
+	#include <vector>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "semirings.h"
+	#include "parallel.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Copy of a SparseMatrix for power-law matrices with a few very long (hub) rows.
+		 *
+		 * Rows up to the threshold stay in CRS, longer rows are moved into a COO tail
+		 * (row, column, value per element). Threads split the CRS rows as usual and
+		 * then the tail into equal element ranges regardless of row boundaries - a row
+		 * crossing a range boundary gets its partial sums combined afterwards
+		 * (segmented reduction), so no thread is stuck with a whole hub row.
+		 */
+		template<typename T>
+		class HybridSparseMatrix
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				explicit HybridSparseMatrix(const SparseMatrix<T> & matrix);
+				HybridSparseMatrix(const SparseMatrix<T> & matrix, size_t threshold); // rows longer than threshold go to the tail
+
+				// longer than a parallel chunk and well above the average row
+				static size_t defaultThreshold(size_t rows, size_t nnz);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+				size_t getThreshold(void) const;
+				size_t getTailNnz(void) const;
+				const std::vector<size_t> & getHubRows(void) const; // rows stored in the tail, ascending
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SparseMatrix<T> toMatrix(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x) const;
+				std::vector<T> operator * (const std::vector<T> & x) const;
+
+				template<typename S>
+				std::vector<T> multiply(const std::vector<T> & x) const; // over semiring S
+
+
+			protected:
+
+				enum : size_t { NONE = static_cast<size_t>(-1) };
+
+
+				size_t m, n, threshold;
+
+				std::vector<size_t> rows, cols; // CRS part, hub rows are empty
+				std::vector<T> vals;
+
+				std::vector<size_t> hubs;
+				std::vector<size_t> tailRows, tailCols; // COO part sorted by row and column
+				std::vector<T> tailVals;
+
+
+				void build(const SparseMatrix<T> & matrix);
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    HybridSparseMatrix<T>::HybridSparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n), threshold(defaultThreshold(matrix.m, matrix.getNnz()))
+    {
+        this->build(matrix);
+    }
+
+
+    template<typename T>
+    HybridSparseMatrix<T>::HybridSparseMatrix(const SparseMatrix<T> & matrix, size_t threshold)
+        : m(matrix.m), n(matrix.n), threshold(threshold)
+    {
+        this->build(matrix);
+    }
+
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::defaultThreshold(size_t rows, size_t nnz)
+    {
+        return std::max<size_t>(Parallel::GRAIN_WORK, rows == 0 ? 0 : 8 * nnz / rows);
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::getNnz(void) const
+    {
+        return this->vals.size() + this->tailVals.size();
+    }
+
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::getThreshold(void) const
+    {
+        return this->threshold;
+    }
+
+
+    template<typename T>
+    size_t HybridSparseMatrix<T>::getTailNnz(void) const
+    {
+        return this->tailVals.size();
+    }
+
+
+    template<typename T>
+    const std::vector<size_t> & HybridSparseMatrix<T>::getHubRows(void) const
+    {
+        return this->hubs;
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    T HybridSparseMatrix<T>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        if (std::binary_search(this->hubs.begin(), this->hubs.end(), row)) {
+            size_t begin = std::lower_bound(this->tailRows.begin(), this->tailRows.end(), row) - this->tailRows.begin();
+            size_t end = std::upper_bound(this->tailRows.begin(), this->tailRows.end(), row) - this->tailRows.begin();
+            std::vector<size_t>::const_iterator it = std::lower_bound(this->tailCols.begin() + begin, this->tailCols.begin() + end, col);
+
+            return it == this->tailCols.begin() + end || *it != col ? T() : this->tailVals[it - this->tailCols.begin()];
+        }
+
+        std::vector<size_t>::const_iterator last = this->cols.begin() + this->rows[row + 1];
+        std::vector<size_t>::const_iterator it = std::lower_bound(this->cols.begin() + this->rows[row], last, col);
+
+        return it == last || *it != col ? T() : this->vals[it - this->cols.begin()];
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> HybridSparseMatrix<T>::toMatrix(void) const
+    {
+        SparseMatrix<T> result(this->m, this->n);
+
+        std::vector<size_t> rows(this->m + 1, 0), cols;
+        std::vector<T> vals;
+
+        cols.reserve(this->getNnz());
+        vals.reserve(this->getNnz());
+
+        size_t tail = 0;
+
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                cols.push_back(this->cols[pos]);
+                vals.push_back(this->vals[pos]);
+            }
+
+            for (; tail < this->tailRows.size() && this->tailRows[tail] == i; tail++) {
+                cols.push_back(this->tailCols[tail]);
+                vals.push_back(this->tailVals[tail]);
+            }
+
+            rows[i + 1] = cols.size();
+        }
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> HybridSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        return this->template multiply<PlusTimes<T> >(x);
+    }
+
+
+    template<typename T>
+    std::vector<T> HybridSparseMatrix<T>::operator * (const std::vector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T>
+    template<typename S>
+    std::vector<T> HybridSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<T> result(this->m, S::zero());
+
+        // regular rows - hub rows are empty here and keep S::zero()
+        Parallel::parallelFor(this->rows, [&] (size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < lastRow; i++) {
+                T sum = S::zero();
+                for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                    sum = S::add(sum, S::multiply(this->vals[pos], x[this->cols[pos]]));
+                }
+
+                result[i] = sum;
+            }
+        });
+
+        size_t tail = this->tailVals.size();
+
+        if (tail == 0) {
+            return result;
+        }
+
+        // tail - equal element ranges, the first and the last row of a range may be shared with neighbours
+        size_t parts = tail < Parallel::MINIMUM_WORK ? 1 : std::max<size_t>(std::min(Parallel::getThreadCount() * Parallel::CHUNKS_PER_THREAD, tail / Parallel::GRAIN_WORK), 1);
+        std::vector<size_t> bounds(parts + 1);
+
+        for (size_t p = 0; p <= parts; p++) {
+            bounds[p] = tail * p / parts;
+        }
+
+        std::vector<size_t> firstRows(parts, NONE), lastRows(parts, NONE);
+        std::vector<T> firstSums(parts, S::zero()), lastSums(parts, S::zero());
+
+        Parallel::run(bounds, [&] (size_t part, size_t begin, size_t end) {
+            size_t pos = begin;
+
+            while (pos < end) {
+                size_t row = this->tailRows[pos];
+                T sum = S::zero();
+
+                for (; pos < end && this->tailRows[pos] == row; pos++) {
+                    sum = S::add(sum, S::multiply(this->tailVals[pos], x[this->tailCols[pos]]));
+                }
+
+                if (firstRows[part] == NONE) {
+                    firstRows[part] = row;
+                    firstSums[part] = sum;
+
+                } else if (pos == end) {
+                    lastRows[part] = row;
+                    lastSums[part] = sum;
+
+                } else { // the whole row is in this range
+                    result[row] = sum;
+                }
+            }
+        });
+
+        // carries in range order
+        for (size_t p = 0; p < parts; p++) {
+            if (firstRows[p] != NONE) {
+                result[firstRows[p]] = S::add(result[firstRows[p]], firstSums[p]);
+            }
+
+            if (lastRows[p] != NONE) {
+                result[lastRows[p]] = S::add(result[lastRows[p]], lastSums[p]);
+            }
+        }
+
+        return result;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void HybridSparseMatrix<T>::build(const SparseMatrix<T> & matrix)
+    {
+        this->rows.assign(this->m + 1, 0);
+
+        for (size_t i = 0; i < this->m; i++) {
+            size_t length = (*(matrix.rows))[i + 1] - (*(matrix.rows))[i];
+
+            if (length > this->threshold) {
+                this->hubs.push_back(i);
+                length = 0;
+            }
+
+            this->rows[i + 1] = this->rows[i] + length;
+        }
+
+        size_t nnz = matrix.getNnz();
+        size_t tail = nnz - this->rows[this->m];
+
+        this->cols.reserve(this->rows[this->m]);
+        this->vals.reserve(this->rows[this->m]);
+        this->tailRows.reserve(tail);
+        this->tailCols.reserve(tail);
+        this->tailVals.reserve(tail);
+
+        size_t next = 0; // next hub row
+
+        for (size_t i = 0; i < this->m; i++) {
+            bool hub = next < this->hubs.size() && this->hubs[next] == i;
+            next += hub ? 1 : 0;
+
+            for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                if (hub) {
+                    this->tailRows.push_back(i);
+                    this->tailCols.push_back((*(matrix.cols))[pos]);
+                    this->tailVals.push_back((*(matrix.vals))[pos]);
+
+                } else {
+                    this->cols.push_back((*(matrix.cols))[pos]);
+                    this->vals.push_back((*(matrix.vals))[pos]);
+                }
+            }
+        }
+    }
+
+	}
+
+#endif
@@ -0,0 +1,482 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_PARTITIONEDSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_PARTITIONEDSPARSEMATRIX_H__
+
+	#include <vector>
+	#include <memory>
+	#include <cstdint>
+	#include <algorithm>
+	#include <type_traits>
+	#include <signal.h>
+	#include <unistd.h>
+	#include <sys/wait.h>
+	#include "exceptions.h"
+	#include "parallel.h"
+	#include "shared.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Square matrix split into row blocks owned by separate worker processes.
+		 *
+		 * Block p owns rows [firstRow, lastRow) and the x elements with the same indices.
+		 * Other x elements its rows need (ghost / halo columns) are received from their
+		 * owners through shared-memory rings before every multiplication, so a block
+		 * only reads its own slice of x. Workers are forked by the constructor and
+		 * stopped by the destructor; multiplications of one matrix must not run concurrently.
+		 */
+		template<typename T>
+		class PartitionedSparseMatrix
+		{
+
+			static_assert(std::is_trivially_copyable<T>::value, "Values are copied between processes byte by byte.");
+
+
+			public:
+
+				struct Block
+				{
+					size_t firstRow, lastRow;
+
+					std::vector<size_t> ghosts; // sorted global columns owned by other blocks
+					std::vector<size_t> ghostOwners; // block owning each ghost
+
+					std::vector<std::vector<size_t> > sends; // sends[q] - owned elements block q needs, relative to firstRow
+
+					// local CRS - columns below the owned count index the owned slice, the rest index ghosts
+					std::vector<size_t> rows, cols;
+					std::vector<T> vals;
+				};
+
+
+				// === CREATION ==============================================
+
+				PartitionedSparseMatrix(const SparseMatrix<T> & matrix, size_t parts);
+				~PartitionedSparseMatrix(void);
+
+				PartitionedSparseMatrix(const PartitionedSparseMatrix<T> &) = delete;
+				PartitionedSparseMatrix<T> & operator = (const PartitionedSparseMatrix<T> &) = delete;
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getPartCount(void) const;
+				size_t getHaloSize(void) const; // ghost elements of all blocks
+				const Block & getBlock(size_t part) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x);
+				std::vector<T> operator * (const std::vector<T> & x);
+
+
+			protected:
+
+				enum Command : uint64_t
+				{
+					MULTIPLY,
+					STOP
+				};
+
+
+				struct Control
+				{
+					std::atomic<uint64_t> generation; // incremented with every command
+					std::atomic<uint64_t> command;
+					std::atomic<uint64_t> done; // workers which finished the command
+				};
+
+
+				size_t n;
+				std::vector<Block> blocks;
+
+				std::unique_ptr<Shared::SharedMemory> memory;
+				Control * control;
+				T * x, * y;
+				std::vector<size_t> ringOffsets; // ring from p to q at ringOffsets[p * parts + q], 0 if none
+
+				std::vector<pid_t> workers;
+				bool failed; // some worker exited, the others may wait for its halo forever
+
+
+				void split(const SparseMatrix<T> & matrix, size_t parts);
+				void allocate(void);
+				void start(void);
+				void serve(size_t part);
+				void stop(void);
+
+				Shared::SharedRing ring(size_t from, size_t to, bool initialize) const;
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    PartitionedSparseMatrix<T>::PartitionedSparseMatrix(const SparseMatrix<T> & matrix, size_t parts)
+        : n(matrix.getRowCount()), control(nullptr), x(nullptr), y(nullptr), failed(false)
+    {
+        if (matrix.getRowCount() != matrix.getColumnCount()) {
+            throw InvalidDimensionsException("Cannot partition: Matrix has to be square.");
+        }
+
+        if (parts < 1) {
+            throw InvalidArgumentException("Cannot partition: At least one part is needed.");
+        }
+
+        this->split(matrix, parts);
+        this->allocate();
+        this->start();
+    }
+
+
+    template<typename T>
+    PartitionedSparseMatrix<T>::~PartitionedSparseMatrix(void)
+    {
+        this->stop();
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t PartitionedSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t PartitionedSparseMatrix<T>::getPartCount(void) const
+    {
+        return this->blocks.size();
+    }
+
+
+    template<typename T>
+    size_t PartitionedSparseMatrix<T>::getHaloSize(void) const
+    {
+        size_t size = 0;
+
+        for (const Block & block : this->blocks) {
+            size += block.ghosts.size();
+        }
+
+        return size;
+    }
+
+
+    template<typename T>
+    const typename PartitionedSparseMatrix<T>::Block & PartitionedSparseMatrix<T>::getBlock(size_t part) const
+    {
+        if (part >= this->blocks.size()) {
+            throw InvalidCoordinatesException("Part out of range.");
+        }
+
+        return this->blocks[part];
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> PartitionedSparseMatrix<T>::multiply(const std::vector<T> & x)
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        if (this->failed) {
+            throw SystemException("Cannot multiply: Worker process exited.");
+        }
+
+        std::copy(x.begin(), x.end(), this->x);
+
+        this->control->done.store(0, std::memory_order_relaxed);
+        this->control->command.store(MULTIPLY, std::memory_order_relaxed);
+        this->control->generation.fetch_add(1, std::memory_order_release);
+
+        size_t spins = 0;
+
+        while (this->control->done.load(std::memory_order_acquire) < this->blocks.size()) {
+            Shared::pause(spins);
+
+            // a crashed worker would never report, check them once in a while
+            if (spins % 1000 == 0) {
+                for (size_t p = 0; p < this->workers.size(); p++) {
+                    if (this->workers[p] > 0 && waitpid(this->workers[p], nullptr, WNOHANG) != 0) {
+                        this->workers[p] = 0;
+                        this->failed = true;
+                        throw SystemException("Cannot multiply: Worker process exited.");
+                    }
+                }
+            }
+        }
+
+        return std::vector<T>(this->y, this->y + this->n);
+    }
+
+
+    template<typename T>
+    std::vector<T> PartitionedSparseMatrix<T>::operator * (const std::vector<T> & x)
+    {
+        return this->multiply(x);
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void PartitionedSparseMatrix<T>::split(const SparseMatrix<T> & matrix, size_t parts)
+    {
+        std::vector<size_t> bounds = Parallel::partition(*(matrix.rows), parts);
+        parts = bounds.size() - 1;
+
+        this->blocks.resize(parts);
+
+        for (size_t p = 0; p < parts; p++) {
+            Block & block = this->blocks[p];
+            block.firstRow = bounds[p];
+            block.lastRow = bounds[p + 1];
+            block.sends.resize(parts);
+
+            size_t owned = block.lastRow - block.firstRow;
+            size_t begin = (*(matrix.rows))[block.firstRow], end = (*(matrix.rows))[block.lastRow];
+
+            for (size_t pos = begin; pos < end; pos++) {
+                size_t col = (*(matrix.cols))[pos];
+
+                if (col < block.firstRow || col >= block.lastRow) {
+                    block.ghosts.push_back(col);
+                }
+            }
+
+            std::sort(block.ghosts.begin(), block.ghosts.end());
+            block.ghosts.erase(std::unique(block.ghosts.begin(), block.ghosts.end()), block.ghosts.end());
+
+            // owners in ghost order, ghosts of one owner are consecutive
+            for (size_t g = 0; g < block.ghosts.size(); g++) {
+                size_t owner = std::upper_bound(bounds.begin(), bounds.end(), block.ghosts[g]) - bounds.begin() - 1;
+                block.ghostOwners.push_back(owner);
+            }
+
+            block.rows.push_back(0);
+
+            for (size_t i = block.firstRow; i < block.lastRow; i++) {
+                for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                    size_t col = (*(matrix.cols))[pos];
+
+                    if (col >= block.firstRow && col < block.lastRow) {
+                        block.cols.push_back(col - block.firstRow);
+
+                    } else {
+                        block.cols.push_back(owned + (std::lower_bound(block.ghosts.begin(), block.ghosts.end(), col) - block.ghosts.begin()));
+                    }
+
+                    block.vals.push_back((*(matrix.vals))[pos]);
+                }
+
+                block.rows.push_back(block.cols.size());
+            }
+        }
+
+        // every ghost is something its owner has to send
+        for (size_t p = 0; p < parts; p++) {
+            const Block & block = this->blocks[p];
+
+            for (size_t g = 0; g < block.ghosts.size(); g++) {
+                Block & owner = this->blocks[block.ghostOwners[g]];
+                owner.sends[p].push_back(block.ghosts[g] - owner.firstRow);
+            }
+        }
+    }
+
+
+    template<typename T>
+    void PartitionedSparseMatrix<T>::allocate(void)
+    {
+        size_t parts = this->blocks.size();
+
+        // control block, x, y, then one ring per communicating pair sized for a whole halo message
+        size_t bytes = Shared::align(sizeof(Control));
+        size_t xOffset = bytes;
+        bytes += Shared::align(this->n * sizeof(T));
+        size_t yOffset = bytes;
+        bytes += Shared::align(this->n * sizeof(T));
+
+        this->ringOffsets.assign(parts * parts, 0);
+
+        for (size_t p = 0; p < parts; p++) {
+            for (size_t q = 0; q < parts; q++) {
+                if (!this->blocks[p].sends[q].empty()) {
+                    this->ringOffsets[p * parts + q] = bytes;
+                    bytes += Shared::SharedRing::footprint(this->blocks[p].sends[q].size() * sizeof(T));
+                }
+            }
+        }
+
+        this->memory.reset(new Shared::SharedMemory(bytes));
+
+        this->control = new (this->memory->data()) Control();
+        this->control->generation.store(0);
+        this->control->command.store(MULTIPLY);
+        this->control->done.store(0);
+
+        this->x = reinterpret_cast<T *>(this->memory->data() + xOffset);
+        this->y = reinterpret_cast<T *>(this->memory->data() + yOffset);
+
+        for (size_t p = 0; p < parts; p++) {
+            for (size_t q = 0; q < parts; q++) {
+                if (this->ringOffsets[p * parts + q] != 0) {
+                    this->ring(p, q, true);
+                }
+            }
+        }
+    }
+
+
+    template<typename T>
+    void PartitionedSparseMatrix<T>::start(void)
+    {
+        for (size_t p = 0; p < this->blocks.size(); p++) {
+            pid_t pid = fork();
+
+            if (pid == -1) {
+                this->failed = true;
+                this->stop();
+                throw SystemException("Cannot start worker process.");
+            }
+
+            if (pid == 0) {
+                // worker never returns into the caller's code, exit skips destructors of the parent's objects
+                try {
+                    this->serve(p);
+                    _exit(0);
+
+                } catch (...) {
+                    _exit(1);
+                }
+            }
+
+            this->workers.push_back(pid);
+        }
+    }
+
+
+    template<typename T>
+    void PartitionedSparseMatrix<T>::serve(size_t part)
+    {
+        const Block & block = this->blocks[part];
+        size_t parts = this->blocks.size(), owned = block.lastRow - block.firstRow;
+
+        std::vector<Shared::SharedRing> outgoing, incoming;
+        std::vector<size_t> targets, sources;
+
+        for (size_t q = 0; q < parts; q++) {
+            if (this->ringOffsets[part * parts + q] != 0) {
+                outgoing.push_back(this->ring(part, q, false));
+                targets.push_back(q);
+            }
+        }
+
+        for (size_t g = 0; g < block.ghosts.size(); g++) {
+            if (g == 0 || block.ghostOwners[g] != block.ghostOwners[g - 1]) {
+                incoming.push_back(this->ring(block.ghostOwners[g], part, false));
+                sources.push_back(g);
+            }
+        }
+
+        sources.push_back(block.ghosts.size());
+
+        // owned slice followed by ghosts, buffers are allocated before the loop
+        std::vector<T> local(owned + block.ghosts.size()), message;
+        uint64_t generation = 0;
+
+        while (true) {
+            size_t spins = 0;
+
+            while (this->control->generation.load(std::memory_order_acquire) == generation) {
+                Shared::pause(spins);
+            }
+
+            generation++;
+
+            if (this->control->command.load(std::memory_order_relaxed) == STOP) {
+                return ;
+            }
+
+            std::copy(this->x + block.firstRow, this->x + block.lastRow, local.begin());
+
+            for (size_t k = 0; k < outgoing.size(); k++) {
+                const std::vector<size_t> & send = block.sends[targets[k]];
+                message.resize(send.size());
+
+                for (size_t e = 0; e < send.size(); e++) {
+                    message[e] = local[send[e]];
+                }
+
+                outgoing[k].write(message.data(), message.size() * sizeof(T));
+            }
+
+            for (size_t k = 0; k < incoming.size(); k++) {
+                incoming[k].read(local.data() + owned + sources[k], (sources[k + 1] - sources[k]) * sizeof(T));
+            }
+
+            for (size_t i = 0; i < owned; i++) {
+                T sum = T();
+                for (size_t pos = block.rows[i]; pos < block.rows[i + 1]; pos++) {
+                    sum = sum + block.vals[pos] * local[block.cols[pos]];
+                }
+
+                this->y[block.firstRow + i] = sum;
+            }
+
+            this->control->done.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+
+    template<typename T>
+    void PartitionedSparseMatrix<T>::stop(void)
+    {
+        if (this->control != nullptr) {
+            this->control->command.store(STOP, std::memory_order_relaxed);
+            this->control->generation.fetch_add(1, std::memory_order_release);
+        }
+
+        for (size_t p = 0; p < this->workers.size(); p++) {
+            if (this->workers[p] > 0) {
+                if (this->failed) {
+                    kill(this->workers[p], SIGKILL);
+                }
+
+                waitpid(this->workers[p], nullptr, 0);
+            }
+        }
+
+        this->workers.clear();
+    }
+
+
+    template<typename T>
+    Shared::SharedRing PartitionedSparseMatrix<T>::ring(size_t from, size_t to, bool initialize) const
+    {
+        return Shared::SharedRing(this->memory->data() + this->ringOffsets[from * this->blocks.size() + to], this->blocks[from].sends[to].size() * sizeof(T), initialize);
+    }
+
+	}
+
+#endif
@@ -0,0 +1,525 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SMALLSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_SMALLSPARSEMATRIX_H__
+
+	#include <array>
+	#include <vector>
+	#include <cstdint>
+	#include <iostream>
+	#include <algorithm>
+	#include <type_traits>
+	#include "exceptions.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Calls f(std::integral_constant<size_t, I>) for I in [First, Count)
+		 *
+		 * @internal
+		 */
+		template<size_t First, size_t Count>
+		struct Unroll
+		{
+			template<typename F>
+			static void run(F & f)
+			{
+				f(std::integral_constant<size_t, First>());
+				Unroll<First + 1, Count>::run(f);
+			}
+		};
+
+
+		template<size_t Count>
+		struct Unroll<Count, Count>
+		{
+			template<typename F>
+			static void run(F &)
+			{}
+		};
+
+
+		/**
+		 * M×N matrix with at most MaxNnz non-zero elements stored inline in CRS format.
+		 *
+		 * Meant for element-level kernels (e.g. FEM stiffness matrices) created in
+		 * large numbers - it never allocates, dimensions of operands are checked
+		 * at compile time and loops over rows are unrolled.
+		 */
+		template<typename T, size_t M, size_t N, size_t MaxNnz = M * N>
+		class SmallSparseMatrix
+		{
+
+			static_assert(M > 0 && N > 0, "SmallSparseMatrix dimensions have to be positive.");
+			static_assert(M < 256 && N < 256, "SmallSparseMatrix is meant for matrices up to 255x255, use SparseMatrix instead.");
+			static_assert(MaxNnz > 0 && MaxNnz <= M * N, "SmallSparseMatrix capacity has to be between 1 and M * N.");
+
+
+			public:
+
+				// sum of two matrices can have at most all elements of both
+				template<size_t K>
+				using Sum = SmallSparseMatrix<T, M, N, (MaxNnz + K < M * N ? MaxNnz + K : M * N)>;
+
+
+				// === CREATION ==============================================
+
+				SmallSparseMatrix(void);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				static constexpr size_t getRowCount(void) { return M; }
+				static constexpr size_t getColumnCount(void) { return N; }
+				static constexpr size_t getCapacity(void) { return MaxNnz; }
+
+				size_t getNnz(void) const;
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SmallSparseMatrix & set(T val, size_t row, size_t col);
+
+				template<size_t Row, size_t Col>
+				T get(void) const; // coordinates checked at compile time
+
+				template<size_t Row, size_t Col>
+				SmallSparseMatrix & set(T val); // coordinates checked at compile time
+
+				SparseMatrix<T> toMatrix(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::array<T, M> multiply(const std::array<T, N> & x) const;
+				std::array<T, M> operator * (const std::array<T, N> & x) const;
+
+				template<size_t P, size_t K>
+				SmallSparseMatrix<T, M, P> multiply(const SmallSparseMatrix<T, N, P, K> & m) const;
+
+				template<size_t P, size_t K>
+				SmallSparseMatrix<T, M, P> operator * (const SmallSparseMatrix<T, N, P, K> & m) const;
+
+				template<size_t K>
+				Sum<K> add(const SmallSparseMatrix<T, M, N, K> & m) const;
+
+				template<size_t K>
+				Sum<K> operator + (const SmallSparseMatrix<T, M, N, K> & m) const;
+
+
+				// === ASSEMBLY ==============================================
+
+				/** Adds element (i, j) to target(rowMap[i], colMap[j]) */
+				void scatterAdd(SparseMatrix<T> & target, const std::array<size_t, M> & rowMap, const std::array<size_t, N> & colMap) const;
+
+				/** Adds the matrix to the block of target starting at (firstRow, firstCol) */
+				void scatterAdd(SparseMatrix<T> & target, size_t firstRow, size_t firstCol) const;
+
+
+				// === FRIEND FUNCTIONS =========================================
+
+				template<typename X, size_t A, size_t B, size_t C, size_t D>
+				friend bool operator == (const SmallSparseMatrix<X, A, B, C> & a, const SmallSparseMatrix<X, A, B, D> & b);
+
+				template<typename X, size_t A, size_t B, size_t C>
+				friend std::ostream & operator << (std::ostream & os, const SmallSparseMatrix<X, A, B, C> & matrix);
+
+				template<typename X, size_t A, size_t B, size_t C>
+				friend class SmallSparseMatrix;
+
+
+			protected:
+
+				typedef uint16_t Index;
+
+				std::array<Index, M + 1> rows;
+				std::array<Index, MaxNnz> cols;
+				std::array<T, MaxNnz> vals;
+
+
+				/** @return Position of the column in the row or position it would be inserted at */
+				size_t find(size_t row, size_t col) const;
+
+				void insert(size_t index, size_t row, size_t col, T val);
+				void remove(size_t index, size_t row);
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    SmallSparseMatrix<T, M, N, MaxNnz>::SmallSparseMatrix(void)
+    {
+        this->rows.fill(0);
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    size_t SmallSparseMatrix<T, M, N, MaxNnz>::getNnz(void) const
+    {
+        return this->rows[M];
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    T SmallSparseMatrix<T, M, N, MaxNnz>::get(size_t row, size_t col) const
+    {
+        if (row >= M || col >= N) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        size_t pos = this->find(row, col);
+        return (pos < this->rows[row + 1] && this->cols[pos] == col) ? this->vals[pos] : T();
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    SmallSparseMatrix<T, M, N, MaxNnz> & SmallSparseMatrix<T, M, N, MaxNnz>::set(T val, size_t row, size_t col)
+    {
+        if (row >= M || col >= N) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        size_t pos = this->find(row, col);
+
+        if (pos == this->rows[row + 1] || this->cols[pos] != col) {
+            if (!(val == T())) {
+                this->insert(pos, row, col, val);
+            }
+
+        } else if (val == T()) {
+            this->remove(pos, row);
+
+        } else {
+            this->vals[pos] = val;
+        }
+
+        return *this;
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t Row, size_t Col>
+    T SmallSparseMatrix<T, M, N, MaxNnz>::get(void) const
+    {
+        static_assert(Row < M && Col < N, "Coordinates out of range.");
+        return this->get(Row, Col);
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t Row, size_t Col>
+    SmallSparseMatrix<T, M, N, MaxNnz> & SmallSparseMatrix<T, M, N, MaxNnz>::set(T val)
+    {
+        static_assert(Row < M && Col < N, "Coordinates out of range.");
+        return this->set(val, Row, Col);
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    SparseMatrix<T> SmallSparseMatrix<T, M, N, MaxNnz>::toMatrix(void) const
+    {
+        SparseMatrix<T> result(M, N);
+
+        result.assign(
+            std::vector<size_t>(this->rows.begin(), this->rows.end()),
+            std::vector<size_t>(this->cols.begin(), this->cols.begin() + this->getNnz()),
+            std::vector<T>(this->vals.begin(), this->vals.begin() + this->getNnz())
+        );
+
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    std::array<T, M> SmallSparseMatrix<T, M, N, MaxNnz>::multiply(const std::array<T, N> & x) const
+    {
+        std::array<T, M> result;
+
+        auto row = [&] (auto i) {
+            T sum = T();
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                sum = sum + this->vals[pos] * x[this->cols[pos]];
+            }
+
+            result[i] = sum;
+        };
+
+        Unroll<0, M>::run(row);
+        return result;
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    std::array<T, M> SmallSparseMatrix<T, M, N, MaxNnz>::operator * (const std::array<T, N> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t P, size_t K>
+    SmallSparseMatrix<T, M, P> SmallSparseMatrix<T, M, N, MaxNnz>::multiply(const SmallSparseMatrix<T, N, P, K> & m) const
+    {
+        SmallSparseMatrix<T, M, P> result;
+
+        // rows are at most 255 wide, so a dense accumulator scanned in column order is cheapest
+        std::array<T, P> accumulator;
+        std::array<bool, P> touched;
+
+        auto row = [&] (auto i) {
+            touched.fill(false);
+
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                size_t k = this->cols[pos];
+
+                for (size_t mpos = m.rows[k]; mpos < m.rows[k + 1]; mpos++) {
+                    size_t j = m.cols[mpos];
+                    T product = this->vals[pos] * m.vals[mpos];
+
+                    accumulator[j] = touched[j] ? accumulator[j] + product : product;
+                    touched[j] = true;
+                }
+            }
+
+            size_t count = result.rows[i];
+            for (size_t j = 0; j < P; j++) {
+                if (touched[j] && !(accumulator[j] == T())) {
+                    result.cols[count] = static_cast<Index>(j);
+                    result.vals[count] = accumulator[j];
+                    count++;
+                }
+            }
+
+            result.rows[i + 1] = static_cast<Index>(count);
+        };
+
+        Unroll<0, M>::run(row);
+        return result;
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t P, size_t K>
+    SmallSparseMatrix<T, M, P> SmallSparseMatrix<T, M, N, MaxNnz>::operator * (const SmallSparseMatrix<T, N, P, K> & m) const
+    {
+        return this->multiply(m);
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t K>
+    typename SmallSparseMatrix<T, M, N, MaxNnz>::template Sum<K> SmallSparseMatrix<T, M, N, MaxNnz>::add(const SmallSparseMatrix<T, M, N, K> & m) const
+    {
+        Sum<K> result;
+
+        auto row = [&] (auto i) {
+            size_t a = this->rows[i], aEnd = this->rows[i + 1];
+            size_t b = m.rows[i], bEnd = m.rows[i + 1];
+            size_t count = result.rows[i];
+
+            while (a < aEnd || b < bEnd) {
+                Index col;
+                T val;
+
+                if (b == bEnd || (a < aEnd && this->cols[a] < m.cols[b])) {
+                    col = this->cols[a];
+                    val = this->vals[a++];
+
+                } else if (a == aEnd || m.cols[b] < this->cols[a]) {
+                    col = m.cols[b];
+                    val = m.vals[b++];
+
+                } else {
+                    col = this->cols[a];
+                    val = this->vals[a++] + m.vals[b++];
+                }
+
+                if (!(val == T())) {
+                    result.cols[count] = col;
+                    result.vals[count] = val;
+                    count++;
+                }
+            }
+
+            result.rows[i + 1] = static_cast<Index>(count);
+        };
+
+        Unroll<0, M>::run(row);
+        return result;
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    template<size_t K>
+    typename SmallSparseMatrix<T, M, N, MaxNnz>::template Sum<K> SmallSparseMatrix<T, M, N, MaxNnz>::operator + (const SmallSparseMatrix<T, M, N, K> & m) const
+    {
+        return this->add(m);
+    }
+
+
+    // === ASSEMBLY ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    void SmallSparseMatrix<T, M, N, MaxNnz>::scatterAdd(SparseMatrix<T> & target, const std::array<size_t, M> & rowMap, const std::array<size_t, N> & colMap) const
+    {
+        // validate everything first so that a failure leaves the target untouched
+        for (size_t i = 0; i < M; i++) {
+            if (rowMap[i] >= target.m) {
+                throw InvalidCoordinatesException("Cannot scatter: row out of range.");
+            }
+        }
+
+        for (size_t j = 0; j < N; j++) {
+            if (colMap[j] >= target.n) {
+                throw InvalidCoordinatesException("Cannot scatter: column out of range.");
+            }
+        }
+
+        target.detachValues(); // values are updated in place below
+
+        for (size_t i = 0; i < M; i++) {
+            size_t row = rowMap[i];
+
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                size_t col = colMap[this->cols[pos]];
+
+                // assembled pattern usually exists already, so the element is found and updated in place
+                size_t index = (*(target.rows))[row];
+                if (target.cols != nullptr) {
+                    std::vector<size_t>::const_iterator begin = target.cols->begin();
+                    index = std::lower_bound(begin + index, begin + (*(target.rows))[row + 1], col) - begin;
+                }
+
+                if (index == (*(target.rows))[row + 1] || (*(target.cols))[index] != col) {
+                    target.insert(index, row, col, this->vals[pos]);
+
+                } else {
+                    T sum = (*(target.vals))[index] + this->vals[pos];
+
+                    if (sum == T() && target.pattern == nullptr) { // shared pattern keeps zeros stored
+                        target.remove(index, row);
+
+                    } else {
+                        (*(target.vals))[index] = sum;
+                    }
+                }
+            }
+        }
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    void SmallSparseMatrix<T, M, N, MaxNnz>::scatterAdd(SparseMatrix<T> & target, size_t firstRow, size_t firstCol) const
+    {
+        std::array<size_t, M> rowMap;
+        std::array<size_t, N> colMap;
+
+        for (size_t i = 0; i < M; i++) {
+            rowMap[i] = firstRow + i;
+        }
+
+        for (size_t j = 0; j < N; j++) {
+            colMap[j] = firstCol + j;
+        }
+
+        this->scatterAdd(target, rowMap, colMap);
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    size_t SmallSparseMatrix<T, M, N, MaxNnz>::find(size_t row, size_t col) const
+    {
+        return std::lower_bound(this->cols.begin() + this->rows[row], this->cols.begin() + this->rows[row + 1], col) - this->cols.begin();
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    void SmallSparseMatrix<T, M, N, MaxNnz>::insert(size_t index, size_t row, size_t col, T val)
+    {
+        size_t nnz = this->getNnz();
+
+        if (nnz == MaxNnz) {
+            throw InvalidArgumentException("Cannot set: matrix capacity exceeded.");
+        }
+
+        std::copy_backward(this->cols.begin() + index, this->cols.begin() + nnz, this->cols.begin() + nnz + 1);
+        std::copy_backward(this->vals.begin() + index, this->vals.begin() + nnz, this->vals.begin() + nnz + 1);
+
+        this->cols[index] = static_cast<Index>(col);
+        this->vals[index] = val;
+
+        for (size_t i = row + 1; i <= M; i++) {
+            this->rows[i]++;
+        }
+    }
+
+
+    template<typename T, size_t M, size_t N, size_t MaxNnz>
+    void SmallSparseMatrix<T, M, N, MaxNnz>::remove(size_t index, size_t row)
+    {
+        size_t nnz = this->getNnz();
+
+        std::copy(this->cols.begin() + index + 1, this->cols.begin() + nnz, this->cols.begin() + index);
+        std::copy(this->vals.begin() + index + 1, this->vals.begin() + nnz, this->vals.begin() + index);
+
+        for (size_t i = row + 1; i <= M; i++) {
+            this->rows[i]--;
+        }
+    }
+
+
+    // === FRIEND FUNCTIONS =========================================
+
+    template<typename X, size_t A, size_t B, size_t C, size_t D>
+    bool operator == (const SmallSparseMatrix<X, A, B, C> & a, const SmallSparseMatrix<X, A, B, D> & b)
+    {
+        return std::equal(a.rows.begin(), a.rows.end(), b.rows.begin())
+            && std::equal(a.cols.begin(), a.cols.begin() + a.getNnz(), b.cols.begin())
+            && std::equal(a.vals.begin(), a.vals.begin() + a.getNnz(), b.vals.begin());
+    }
+
+
+    template<typename X, size_t A, size_t B, size_t C>
+    std::ostream & operator << (std::ostream & os, const SmallSparseMatrix<X, A, B, C> & matrix)
+    {
+        for (size_t i = 0; i < A; i++) {
+            for (size_t j = 0; j < B; j++) {
+                if (j != 0) {
+                    os << " ";
+                }
+
+                os << matrix.get(i, j);
+            }
+
+            if (i < A - 1) {
+                os << std::endl;
+            }
+        }
+
+        return os;
+    }
+
+	}
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SNAPSHOTHANDLE_H__
+
+	#define	__SPARSEMATRIX_SNAPSHOTHANDLE_H__
+
+	#include <mutex>
+	#include <atomic>
+	#include <memory>
+	#include <thread>
+	#include <vector>
+	#include <algorithm>
+	#include <functional>
+	#include "exceptions.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Publishes frozen matrices to concurrent readers (RCU style).
+		 *
+		 * Readers acquire() the current snapshot and keep using it for as long
+		 * as they hold the returned pointer. The writer builds the next version
+		 * aside and publish()es it with an atomic swap; the previous version is
+		 * reclaimed once its last reader drops it.
+		 *
+		 * The current version is an atomic raw pointer. A reader announces the
+		 * pointer it is about to copy in a hazard slot and checks that it is still
+		 * current, so acquire() only uses lock-free atomics and never waits for the
+		 * writer. Replaced versions are retired by the writer and deleted once no
+		 * slot announces them. Concurrent writers serialize on a mutex which
+		 * readers never touch.
+		 */
+		template<typename T>
+		class SnapshotHandle
+		{
+
+			public:
+
+				typedef std::shared_ptr<const SparseMatrix<T> > Snapshot;
+
+
+				// === CREATION ==============================================
+
+				explicit SnapshotHandle(const SparseMatrix<T> & matrix);
+				explicit SnapshotHandle(Snapshot snapshot);
+				~SnapshotHandle(void);
+
+				SnapshotHandle(const SnapshotHandle<T> & handle) = delete;
+				SnapshotHandle<T> & operator = (const SnapshotHandle<T> & handle) = delete;
+
+
+				// === READERS ==============================================
+
+				Snapshot acquire(void) const;
+				static bool isLockFree(void); // acquire() doesn't fall back to locks on this platform
+
+
+				// === WRITER ==============================================
+
+				void publish(const SparseMatrix<T> & matrix);
+				void publish(Snapshot snapshot);
+				Snapshot exchange(Snapshot snapshot); // returns the replaced version
+
+
+			protected:
+
+				struct Version
+				{
+					Snapshot snapshot;
+
+					explicit Version(Snapshot snapshot) : snapshot(snapshot)
+					{}
+				};
+
+
+				// one cache line per slot, so that readers don't write to the same line
+				struct HazardSlot
+				{
+					std::atomic<Version *> version;
+					char padding[64 - sizeof(std::atomic<Version *>)];
+
+					HazardSlot(void) : version(nullptr)
+					{}
+				};
+
+
+				enum : size_t { HAZARD_SLOTS = 64 };
+
+
+				std::atomic<Version *> current;
+				mutable HazardSlot hazards[HAZARD_SLOTS];
+
+				std::mutex writer;
+				std::vector<Version *> retired; // replaced versions possibly still read, guarded by writer
+
+
+				void reclaim(void);
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    SnapshotHandle<T>::SnapshotHandle(const SparseMatrix<T> & matrix) : current(new Version(matrix.freeze()))
+    {}
+
+
+    template<typename T>
+    SnapshotHandle<T>::SnapshotHandle(Snapshot snapshot) : current(nullptr)
+    {
+        if (snapshot == nullptr) {
+            throw InvalidArgumentException("Cannot publish empty snapshot.");
+        }
+
+        this->current.store(new Version(snapshot));
+    }
+
+
+    template<typename T>
+    SnapshotHandle<T>::~SnapshotHandle(void)
+    {
+        // no reader may use the handle any more
+        delete this->current.load();
+
+        for (Version * version : this->retired) {
+            delete version;
+        }
+    }
+
+
+    // === READERS ==============================================
+
+    template<typename T>
+    typename SnapshotHandle<T>::Snapshot SnapshotHandle<T>::acquire(void) const
+    {
+        Version * version = this->current.load();
+
+        // claim a free slot, starting at a per-thread position to avoid contention
+        size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % HAZARD_SLOTS;
+        Version * expected = nullptr;
+
+        while (!this->hazards[slot].version.compare_exchange_weak(expected, version)) {
+            expected = nullptr;
+            slot = (slot + 1) % HAZARD_SLOTS;
+        }
+
+        // announced version may have been replaced (and retired) meanwhile - announce the new one
+        for (Version * latest = this->current.load(); latest != version; latest = this->current.load()) {
+            version = latest;
+            this->hazards[slot].version.store(version);
+        }
+
+        Snapshot snapshot = version->snapshot;
+        this->hazards[slot].version.store(nullptr, std::memory_order_release);
+
+        return snapshot;
+    }
+
+
+    template<typename T>
+    bool SnapshotHandle<T>::isLockFree(void)
+    {
+        std::atomic<Version *> pointer(nullptr);
+        return pointer.is_lock_free();
+    }
+
+
+    // === WRITER ==============================================
+
+    template<typename T>
+    void SnapshotHandle<T>::publish(const SparseMatrix<T> & matrix)
+    {
+        this->publish(matrix.freeze());
+    }
+
+
+    template<typename T>
+    void SnapshotHandle<T>::publish(Snapshot snapshot)
+    {
+        this->exchange(snapshot);
+    }
+
+
+    template<typename T>
+    typename SnapshotHandle<T>::Snapshot SnapshotHandle<T>::exchange(Snapshot snapshot)
+    {
+        if (snapshot == nullptr) {
+            throw InvalidArgumentException("Cannot publish empty snapshot.");
+        }
+
+        Version * version = new Version(snapshot);
+
+        std::lock_guard<std::mutex> lock(this->writer);
+        Version * previous = this->current.exchange(version);
+        Snapshot replaced = previous->snapshot;
+
+        this->retired.push_back(previous);
+        this->reclaim();
+
+        return replaced;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void SnapshotHandle<T>::reclaim(void)
+    {
+        std::vector<Version *> announced;
+        announced.reserve(HAZARD_SLOTS);
+
+        for (size_t slot = 0; slot < HAZARD_SLOTS; slot++) {
+            Version * version = this->hazards[slot].version.load();
+
+            if (version != nullptr) {
+                announced.push_back(version);
+            }
+        }
+
+        size_t kept = 0;
+
+        for (Version * version : this->retired) {
+            if (std::find(announced.begin(), announced.end(), version) == announced.end()) {
+                delete version;
+
+            } else {
+                this->retired[kept++] = version;
+            }
+        }
+
+        this->retired.resize(kept);
+    }
+
+	}
+
+#endif
@@ -10,9 +10,23 @@
 
 	#define	__SPARSEMATRIX_H__
 
+	#include <memory>
+	#include <atomic>
 	#include <vector>
+	#include <functional>
+	#include <utility>
+	#include <numeric>
 	#include <iostream>
+	#include <algorithm>
+	#include <cmath>
     #include "exceptions.h"
+    #include "semirings.h"
+    #include "SparseMatrixView.h"
+    #include "SparsePattern.h"
+    #include "stats.h"
+    #include "parallel.h"
+    #include "accumulator.h"
+    #include "reductions.h"
 
 
 	namespace Sparse
@@ -24,12 +38,30 @@
 
 			public:
 
+				struct MemoryUsage // bytes held by the matrix
+				{
+					size_t rows, cols, vals, total;
+				};
+
+
+				enum Norm
+				{
+					NORM_1, // maximum absolute column sum, sum of absolute values of a row
+					NORM_2, // Euclidean norm of a row, not available for the whole matrix
+					NORM_INF, // maximum absolute row sum, maximum absolute value of a row
+					NORM_FROBENIUS // square root of the sum of squares
+				};
+
+
 				// === CREATION ==============================================
 
 				SparseMatrix(size_t n); // square matrix n×n
 				SparseMatrix(size_t rows, size_t columns); // general matrix
 
-				SparseMatrix(const SparseMatrix<T> & m); // copy constructor
+				explicit SparseMatrix(std::shared_ptr<const SparsePattern> pattern); // shared pattern, zero values
+				SparseMatrix(std::shared_ptr<const SparsePattern> pattern, std::vector<T> values); // shared pattern, values in CRS order
+
+				SparseMatrix(const SparseMatrix<T> & m); // copy constructor, shares the arrays until either matrix changes
 				SparseMatrix<T> & operator = (const SparseMatrix<T> & m);
 
 				~SparseMatrix(void);
@@ -39,14 +71,26 @@
 
                 size_t getRowCount(void) const;
                 size_t getColumnCount(void) const;
+                size_t getNnz(void) const; // number of stored (non-zero) elements
+                std::shared_ptr<const SparsePattern> getSharedPattern(void) const; // nullptr if the matrix owns its pattern
+                bool isShared(void) const; // values shared with a copy, cloned on the first change
 
 
 				// === VALUES ==============================================
 
 				T get(size_t row, size_t col) const;
+				bool contains(size_t row, size_t col) const; // element is stored, even if equal to T()
 				SparseMatrix & set(T val, size_t row, size_t col);
-                SparseMatrix<T> getColumn(size_t col);
-                SparseMatrix<T> getColumnTransposed(size_t col);
+                SparseMatrix<T> getColumn(size_t col) const;
+                SparseMatrix<T> getColumnTransposed(size_t col) const;
+                SparseMatrix<T> submatrix(const std::vector<size_t> & rowIndices, const std::vector<size_t> & colIndices) const;
+                SparseMatrix & setValues(const std::vector<T> & values); // all stored values in CRS order, pattern is kept
+
+
+				// === VIEWS ==============================================
+
+				SparseMatrixView<T> rowRange(size_t first, size_t last) const; // rows [first, last) sharing storage
+				std::vector<SparseMatrixView<T> > partitionRows(size_t parts) const; // ranges with balanced non-zero counts
 
 
 				// === OPERATIONS ==============================================
@@ -57,15 +101,79 @@
 				SparseMatrix<T> multiply(const SparseMatrix<T> & m) const;
 				SparseMatrix<T> operator * (const SparseMatrix<T> & m) const;
 
+				template<typename S>
+				std::vector<T> multiply(const std::vector<T> & x) const; // over semiring S
+
+				template<typename S>
+				SparseMatrix<T> multiply(const SparseMatrix<T> & m) const; // over semiring S, elements equal to S::zero() are left out
+
+				template<typename S = PlusTimes<T>, typename X = T>
+				SparseMatrix<T> multiplyMasked(const SparseMatrix<T> & m, const SparseMatrix<X> & mask, bool complement = false) const; // only elements in (or out of) mask pattern
+
 				SparseMatrix<T> add(const SparseMatrix<T> & m) const;
 				SparseMatrix<T> operator + (const SparseMatrix<T> & m) const;
 
 				SparseMatrix<T> subtract(const SparseMatrix<T> & m) const;
 				SparseMatrix<T> operator - (const SparseMatrix<T> & m) const;
 
+				SparseMatrix<T> transpose(void) const;
+
+
+				// === NUMERIC OPERATIONS ==============================================
+
+				// only values of result are recomputed, its pattern has to contain the pattern of the result and zeros stay stored
+				template<typename S = PlusTimes<T> >
+				void multiplyInto(const SparseMatrix<T> & m, SparseMatrix<T> & result) const;
+
+				void addInto(const SparseMatrix<T> & m, SparseMatrix<T> & result) const;
+
+
+				// === IN-PLACE OPERATIONS ==============================================
+
+				SparseMatrix<T> & scale(const T & alpha); // this = alpha * this
+				SparseMatrix<T> & axpy(const T & alpha, const SparseMatrix<T> & m); // this = this + alpha * m
+				SparseMatrix<T> & hadamard(const SparseMatrix<T> & m); // element-wise product
+
+				template<typename F>
+				SparseMatrix<T> & apply(F f); // f(value) on every non-zero element
+
                 void addSubmatrix(const SparseMatrix<T> & m);
 
 
+				// === REDUCTIONS ==============================================
+
+				std::vector<T> rowSums(void) const;
+				std::vector<T> columnSums(void) const;
+				std::vector<T> rowNorms(Norm norm = NORM_2) const;
+				T norm(Norm norm = NORM_FROBENIUS) const;
+				T min(void) const; // of all elements, zeros included
+				T max(void) const; // of all elements, zeros included
+				std::vector<size_t> rowNnz(void) const;
+				std::vector<T> diagonal(void) const; // elements (i, i) for i < min(m, n)
+
+
+				// === COMPOSITION ==============================================
+
+				static SparseMatrix<T> vstack(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks);
+				static SparseMatrix<T> hstack(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks);
+				static SparseMatrix<T> blockDiag(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks);
+				static SparseMatrix<T> block(const std::vector<std::vector<const SparseMatrix<T> *> > & blocks); // nullptr is zero block
+				static SparseMatrix<T> kron(const SparseMatrix<T> & a, const SparseMatrix<T> & b); // Kronecker product
+
+
+				// === CAPACITY ==============================================
+
+				void reserve(size_t nnz);
+				void reserve(const std::vector<size_t> & rowCapacities); // expected non-zero count of each row
+				void shrinkToFit(void);
+				MemoryUsage memoryUsage(void) const;
+
+
+				// === SNAPSHOTS ==============================================
+
+				std::shared_ptr<const SparseMatrix<T> > freeze(void) const; // immutable shareable copy
+
+
 				// === FRIEND FUNCTIONS =========================================
 
 				template<typename X>
@@ -77,23 +185,87 @@
 				template<typename X>
 				friend std::ostream & operator << (std::ostream & os, const SparseMatrix<X> & matrix);
 
+				template<typename X>
+				friend class SparseMatrix;
+
+				template<typename X>
+				friend class SparseMatrixView;
+
+				friend class SparsePattern;
+
+				template<typename X>
+				friend class TiledSparseMatrix;
+
+				template<typename V, typename A>
+				friend class CompactSparseMatrix;
+
+				template<typename X, size_t M, size_t N, size_t MaxNnz>
+				friend class SmallSparseMatrix;
+
+				template<typename X>
+				friend class TriangularSolver;
+
+				template<typename X>
+				friend class CholeskySolver;
+
+				template<typename X>
+				friend class PartitionedSparseMatrix;
+
+				template<typename X>
+				friend class DeltaSparseMatrix;
+
+				template<typename X>
+				friend class HybridSparseMatrix;
+
+				template<typename X>
+				friend class ColumnSparseMatrix;
+
+				template<typename X>
+				friend class DiagonalSparseMatrix;
+
+				template<typename X>
+				friend class AutoTuner;
+
 
 			protected:
 
                 size_t m, n;
 
-				std::vector<T> * vals;
-				std::vector<size_t> * rows, * cols;
+				// copy-on-write - copies share the arrays, detachStructure() / detachValues() clone them before a change
+				std::shared_ptr<std::vector<T> > vals;
+				std::shared_ptr<std::vector<size_t> > rows, cols;
+
+				std::shared_ptr<const SparsePattern> pattern; // owner of rows and cols when they are shared
 
 
 				// === HELPERS / VALIDATORS ==============================================
 
 				void construct(size_t m, size_t n);
-				void destruct(void);
-				void deepCopy(const SparseMatrix<T> & m);
+				void detachStructure(void); // own rows and cols before changing them
+				void detachValues(void); // own vals before changing them
 				void validateCoordinates(size_t row, size_t col) const;
 				void insert(size_t index, size_t row, size_t col, T val);
 				void remove(size_t index, size_t row);
+				void assign(std::vector<size_t> && rows, std::vector<size_t> && cols, std::vector<T> && vals);
+				void replaceValues(std::vector<T> && values); // zeros stay stored
+				bool hasSamePattern(const SparseMatrix<T> & m) const;
+				bool containsPattern(const SparseMatrix<T> & m) const; // every element of m is stored in this
+				void prune(void);
+				void transposeInto(std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals) const;
+
+				template<typename F>
+				SparseMatrix<T> merge(const SparseMatrix<T> & m, F f) const; // f(a, b) over the union of patterns, T() for missing elements
+
+				static void compact(std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals, const std::vector<size_t> & kept);
+
+				template<typename F>
+				std::vector<T> reduceRows(F f) const; // f(values, count) of every row
+
+				template<typename F, typename Op>
+				T reduceAll(const T & identity, F f, Op op) const; // op over f(value) of all stored values
+
+				template<typename F>
+				std::vector<T> sumColumns(F f) const; // sum of f(value) of every column
 
 		};
 
@@ -114,43 +286,58 @@
 
 
     template<typename T>
-    SparseMatrix<T>::SparseMatrix(const SparseMatrix<T> & matrix)
-    {
-        this->deepCopy(matrix);
-    }
+    SparseMatrix<T>::SparseMatrix(std::shared_ptr<const SparsePattern> pattern)
+        : SparseMatrix(pattern, std::vector<T>(pattern == nullptr ? 0 : pattern->getNnz()))
+    {}
 
 
     template<typename T>
-    SparseMatrix<T> & SparseMatrix<T>::operator = (const SparseMatrix<T> & matrix)
+    SparseMatrix<T>::SparseMatrix(std::shared_ptr<const SparsePattern> pattern, std::vector<T> values)
     {
-        if (&matrix != this) {
-            this->destruct();
-            this->deepCopy(matrix);
+        if (pattern == nullptr) {
+            throw InvalidArgumentException("Pattern cannot be null.");
         }
 
-        return *this;
+        if (values.size() != pattern->getNnz()) {
+            throw InvalidDimensionsException("Value count and pattern element count don't match.");
+        }
+
+        this->m = pattern->m;
+        this->n = pattern->n;
+        this->pattern = pattern;
+
+        // aliases of the pattern arrays, never written through while the pattern is shared, see detachStructure()
+        this->rows = std::shared_ptr<std::vector<size_t> >(pattern, const_cast<std::vector<size_t> *>(&pattern->rows));
+        this->cols = std::shared_ptr<std::vector<size_t> >(pattern, const_cast<std::vector<size_t> *>(&pattern->cols));
+        this->vals = std::make_shared<std::vector<T> >(std::move(values));
+        SPARSEMATRIX_STATS_ALLOCATED(this->vals->size() * sizeof(T));
     }
 
 
     template<typename T>
-    void SparseMatrix<T>::deepCopy(const SparseMatrix<T> & matrix)
+    SparseMatrix<T>::SparseMatrix(const SparseMatrix<T> & matrix)
+        : m(matrix.m), n(matrix.n), vals(matrix.vals), rows(matrix.rows), cols(matrix.cols), pattern(matrix.pattern)
+    {}
+
+
+    template<typename T>
+    SparseMatrix<T> & SparseMatrix<T>::operator = (const SparseMatrix<T> & matrix)
     {
+        // arrays are shared, the first change of either matrix clones them
         this->m = matrix.m;
         this->n = matrix.n;
-        this->rows = new std::vector<size_t>(*(matrix.rows));
+        this->vals = matrix.vals;
+        this->rows = matrix.rows;
+        this->cols = matrix.cols;
+        this->pattern = matrix.pattern;
 
-        if (matrix.vals != nullptr) {
-            this->cols = new std::vector<size_t>(*(matrix.cols));
-            this->vals = new std::vector<T>(*(matrix.vals));
-        }
+        return *this;
     }
 
 
     template<typename T>
     SparseMatrix<T>::~SparseMatrix(void)
-    {
-        this->destruct();
-    }
+    {}
 
 
     template<typename T>
@@ -165,35 +352,45 @@
 
         this->vals = nullptr;
         this->cols = nullptr;
-        this->rows = new std::vector<size_t>(rows + 1, 0);
+        this->rows = std::make_shared<std::vector<size_t> >(rows + 1, 0);
+        SPARSEMATRIX_STATS_ALLOCATED((rows + 1) * sizeof(size_t));
     }
 
 
+    // === GETTERS / SETTERS ==============================================
+
     template<typename T>
-    void SparseMatrix<T>::destruct(void)
+    size_t SparseMatrix<T>::getRowCount(void) const
     {
-        if (this->vals != nullptr) {
-            delete this->vals;
-            delete this->cols;
-        }
+        return this->m;
+    }
 
-        delete this->rows;
+
+    template<typename T>
+    size_t SparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
     }
 
 
-    // === GETTERS / SETTERS ==============================================
+    template<typename T>
+    size_t SparseMatrix<T>::getNnz(void) const
+    {
+        return (*(this->rows))[this->m];
+    }
+
 
     template<typename T>
-    size_t SparseMatrix<T>::getRowCount(void) const
+    std::shared_ptr<const SparsePattern> SparseMatrix<T>::getSharedPattern(void) const
     {
-        return this->m;
+        return this->pattern;
     }
 
 
     template<typename T>
-    size_t SparseMatrix<T>::getColumnCount(void) const
+    bool SparseMatrix<T>::isShared(void) const
     {
-        return this->n;
+        return this->vals != nullptr && this->vals.use_count() > 1;
     }
 
 
@@ -202,6 +399,8 @@
     template<typename T>
     T SparseMatrix<T>::get(size_t row, size_t col) const
     {
+        SPARSEMATRIX_STATS_TIME(GET);
+
         this->validateCoordinates(row, col);
 
         size_t currCol;
@@ -221,9 +420,28 @@
     }
 
 
+    template<typename T>
+    bool SparseMatrix<T>::contains(size_t row, size_t col) const
+    {
+        this->validateCoordinates(row, col);
+
+        if (this->getNnz() == 0) {
+            return false;
+        }
+
+        const size_t * cols = this->cols->data();
+        const size_t * last = cols + (*(this->rows))[row + 1];
+        const size_t * it = std::lower_bound(cols + (*(this->rows))[row], last, col);
+
+        return it != last && *it == col;
+    }
+
+
     template<typename T>
     SparseMatrix<T> & SparseMatrix<T>::set(T val, size_t row, size_t col)
     {
+        SPARSEMATRIX_STATS_TIME(SET);
+
         this->validateCoordinates(row, col);
 
         size_t pos = (*(this->rows))[row];
@@ -242,184 +460,203 @@
                 this->insert(pos, row, col, val);
             }
 
-        } else if (val == T()) {
+        } else if (val == T() && this->pattern == nullptr) { // shared pattern keeps zeros stored
             this->remove(pos, row);
 
         } else {
+            this->detachValues();
             (*(this->vals))[pos] = val;
         }
 
         return *this;
     }
 
+
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::getColumn(size_t col)
+    SparseMatrix<T> & SparseMatrix<T>::setValues(const std::vector<T> & values)
     {
-        this->validateCoordinates(0, col);
-        SparseMatrix<T> outM(this->m, 1);
+        if (values.size() != this->getNnz()) {
+            throw InvalidDimensionsException("Cannot set values: value count and non-zero element count don't match.");
+        }
 
-        if (this->vals != nullptr) { // only if any value set
-            for (size_t i = 0; i < this->m; i++) {
-                for (size_t pos = (*(this->rows))[i]; pos < (*(this->rows))[i + 1]; pos++) {
-                    size_t j = (*(this->cols))[pos];
-                    if (col == j) {
-                        auto val = (*(this->vals))[pos];
-                        outM.set(val, i, 0);
-                    }
-                }
-            }
+        if (!values.empty()) {
+            this->replaceValues(std::vector<T>(values));
+            this->prune();
         }
-        return outM;
+
+        return *this;
     }
-    
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::getColumn(size_t col) const
+    {
+        return this->getColumnTransposed(col).transpose();
+    }
+
+
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::getColumnTransposed(size_t col)
+    SparseMatrix<T> SparseMatrix<T>::getColumnTransposed(size_t col) const
     {
         this->validateCoordinates(0, col);
         SparseMatrix<T> outM(1, this->m);
 
         if (this->vals != nullptr) { // only if any value set
+            std::vector<size_t> rows(2, 0), cols;
+            std::vector<T> vals;
+
             for (size_t i = 0; i < this->m; i++) {
-                for (size_t pos = (*(this->rows))[i]; pos < (*(this->rows))[i + 1]; pos++) {
-                    size_t j = (*(this->cols))[pos];
-                    if (col == j) {
-                        auto val = (*(this->vals))[pos];
-                        outM.set(val, 0, i);
-                    }
+                std::vector<size_t>::const_iterator begin = this->cols->begin() + (*(this->rows))[i];
+                std::vector<size_t>::const_iterator end = this->cols->begin() + (*(this->rows))[i + 1];
+                std::vector<size_t>::const_iterator pos = std::lower_bound(begin, end, col);
+
+                if (pos != end && *pos == col) {
+                    cols.push_back(i);
+                    vals.push_back((*(this->vals))[pos - this->cols->begin()]);
                 }
             }
+
+            rows[1] = cols.size();
+            outM.assign(std::move(rows), std::move(cols), std::move(vals));
         }
+
         return outM;
     }
 
-    // === OPERATIONS ==============================================
 
     template<typename T>
-    std::vector<T> SparseMatrix<T>::multiply(const std::vector<T> & x) const
+    SparseMatrix<T> SparseMatrix<T>::submatrix(const std::vector<size_t> & rowIndices, const std::vector<size_t> & colIndices) const
     {
-        if (this->n != (int) x.size()) {
-            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
-        }
+        SparseMatrix<T> result(rowIndices.size(), colIndices.size());
 
-        std::vector<T> result(this->m, T());
+        // maps column of this matrix to column of the result
+        const size_t skipped = this->n;
+        std::vector<size_t> columnMap(this->n, skipped);
+        bool ordered = true;
 
-        if (this->vals != nullptr) { // only if any value set
-            for (size_t i = 0; i < this->m; i++) {
-                T sum = T();
-                for (size_t j = (*(this->rows))[i]; j < (*(this->rows))[i + 1]; j++) {
-                    sum = sum + (*(this->vals))[j] * x[(*(this->cols))[j]];
-                }
+        for (size_t c = 0; c < colIndices.size(); c++) {
+            this->validateCoordinates(0, colIndices[c]);
 
-                result[i] = sum;
+            if (columnMap[colIndices[c]] != skipped) {
+                throw InvalidArgumentException("Cannot extract submatrix: column indices contain duplicates.");
             }
-        }
 
-        return result;
-    }
+            columnMap[colIndices[c]] = c;
+            ordered = ordered && (c == 0 || colIndices[c - 1] < colIndices[c]);
+        }
 
+        std::vector<size_t> rows(rowIndices.size() + 1, 0), cols;
+        std::vector<T> vals;
+        std::vector<std::pair<size_t, T> > entries;
 
-    template<typename T>
-    std::vector<T> SparseMatrix<T>::operator * (const std::vector<T> & x) const
-    {
-        return this->multiply(x);
-    }
+        for (size_t r = 0; r < rowIndices.size(); r++) {
+            this->validateCoordinates(rowIndices[r], 0);
 
+            size_t rowStart = cols.size();
 
-    template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::multiply(const SparseMatrix<T> & m) const
-    {
-        if (this->n != m.m) {
-            throw InvalidDimensionsException("Cannot multiply: Left matrix column count and right matrix row count don't match.");
-        }
+            for (size_t pos = (*(this->rows))[rowIndices[r]]; pos < (*(this->rows))[rowIndices[r] + 1]; pos++) {
+                size_t target = columnMap[(*(this->cols))[pos]];
 
-        SparseMatrix<T> result(this->m, m.n);
+                if (target != skipped) {
+                    cols.push_back(target);
+                    vals.push_back((*(this->vals))[pos]);
+                }
+            }
 
-        T a;
+            if (!ordered) { // permuted columns have to be sorted again
+                entries.clear();
 
-        // TODO: more efficient?
-        // @see http://www.math.tamu.edu/~srobertp/Courses/Math639_2014_Sp/CRSDescription/CRSStuff.pdf
+                for (size_t pos = rowStart; pos < cols.size(); pos++) {
+                    entries.push_back(std::make_pair(cols[pos], vals[pos]));
+                }
 
-        for (size_t i = 0; i < this->m; i++) {
-            for (size_t j = 0; j < m.n; j++) {
-                a = T();
+                std::sort(entries.begin(), entries.end(), [] (const std::pair<size_t, T> & a, const std::pair<size_t, T> & b) {
+                    return a.first < b.first;
+                });
 
-                for (size_t k = 0; k < this->n; k++) {
-                    a = a + this->get(i, k) * m.get(k, j);
+                for (size_t e = 0; e < entries.size(); e++) {
+                    cols[rowStart + e] = entries[e].first;
+                    vals[rowStart + e] = entries[e].second;
                 }
-
-                result.set(a, i, j);
             }
+
+            rows[r + 1] = cols.size();
         }
 
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
         return result;
     }
 
 
+    // === VIEWS ==============================================
+
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::operator * (const SparseMatrix<T> & m) const
+    SparseMatrixView<T> SparseMatrix<T>::rowRange(size_t first, size_t last) const
     {
-        return this->multiply(m);
+        if (first >= last || last > this->m) {
+            throw InvalidCoordinatesException("Row range out of range.");
+        }
+
+        return SparseMatrixView<T>(
+            last - first,
+            this->n,
+            this->rows->data() + first,
+            this->cols == nullptr ? nullptr : this->cols->data(),
+            this->vals == nullptr ? nullptr : this->vals->data(),
+            first
+        );
     }
 
 
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::add(const SparseMatrix<T> & m) const
+    std::vector<SparseMatrixView<T> > SparseMatrix<T>::partitionRows(size_t parts) const
     {
-        if (this->m != m.m || this->n != m.n) {
-            throw InvalidDimensionsException("Cannot add: matrices dimensions don't match.");
-        }
-
-        SparseMatrix<T> result(this->m, this->n);
+        std::vector<size_t> bounds = Parallel::partition(*(this->rows), parts);
+        std::vector<SparseMatrixView<T> > views;
 
-        // TODO: more efficient?
-        // @see http://www.math.tamu.edu/~srobertp/Courses/Math639_2014_Sp/CRSDescription/CRSStuff.pdf
-
-        for (size_t i = 0; i < this->m; i++) {
-            for (size_t j = 0; j < this->n; j++) {
-                result.set(this->get(i, j) + m.get(i, j), i, j);
-            }
+        for (size_t p = 0; p + 1 < bounds.size(); p++) {
+            views.push_back(this->rowRange(bounds[p], bounds[p + 1]));
         }
 
-        return result;
+        return views;
     }
 
 
-    template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::operator + (const SparseMatrix<T> & m) const
-    {
-        return this->add(m);
-    }
+    // === OPERATIONS ==============================================
 
     template<typename T>
-    void SparseMatrix<T>::addSubmatrix(const SparseMatrix<T> & m)
+    std::vector<T> SparseMatrix<T>::multiply(const std::vector<T> & x) const
     {
-        if (this->m < m.m || this->n < m.n) {
-            throw InvalidDimensionsException("Cannot add submatrix with bigger dimension.");
-        }
-
-        for (size_t i = 0; i < m.m; i++) {
-            for (size_t j = 0; j < m.n; j++) {
-                this->set(this->get(i, j) + m.get(i, j), i, j);
-            }
-        }
+        return this->template multiply<PlusTimes<T> >(x);
     }
 
+
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::subtract(const SparseMatrix<T> & m) const
+    template<typename S>
+    std::vector<T> SparseMatrix<T>::multiply(const std::vector<T> & x) const
     {
-        if (this->m != m.m || this->n != m.n) {
-            throw InvalidDimensionsException("Cannot subtract: matrices dimensions don't match.");
+        SPARSEMATRIX_STATS_TIME(MULTIPLY_VECTOR);
+
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
         }
 
-        SparseMatrix<T> result(this->m, this->n);
+        std::vector<T> result(this->m, S::zero());
 
-        // TODO: more efficient?
-        // @see http://www.math.tamu.edu/~srobertp/Courses/Math639_2014_Sp/CRSDescription/CRSStuff.pdf
+        if (this->vals != nullptr) { // only if any value set
+            const size_t * rowPtr = this->rows->data();
+            const size_t * colIdx = this->cols->data();
+            const T * values = this->vals->data();
+
+            Parallel::parallelFor(*(this->rows), [&] (size_t firstRow, size_t lastRow) {
+                for (size_t i = firstRow; i < lastRow; i++) {
+                    T sum = S::zero();
+                    for (size_t j = rowPtr[i]; j < rowPtr[i + 1]; j++) {
+                        sum = S::add(sum, S::multiply(values[j], x[colIdx[j]]));
+                    }
 
-        for (size_t i = 0; i < this->m; i++) {
-            for (size_t j = 0; j < this->n; j++) {
-                result.set(this->get(i, j) - m.get(i, j), i, j);
-            }
+                    result[i] = sum;
+                }
+            });
         }
 
         return result;
@@ -427,63 +664,1534 @@
 
 
     template<typename T>
-    SparseMatrix<T> SparseMatrix<T>::operator - (const SparseMatrix<T> & m) const
+    std::vector<T> SparseMatrix<T>::operator * (const std::vector<T> & x) const
     {
-        return this->subtract(m);
+        return this->multiply(x);
     }
 
 
-    // === HELPERS / VALIDATORS ==============================================
-
     template<typename T>
-    void SparseMatrix<T>::validateCoordinates(size_t row, size_t col) const
+    SparseMatrix<T> SparseMatrix<T>::multiply(const SparseMatrix<T> & m) const
     {
-        if (row < 0 || col < 0 || row >= this->m || col >= this->n) {
-            throw InvalidCoordinatesException("Coordinates out of range.");
-        }
+        return this->template multiply<PlusTimes<T> >(m);
     }
 
 
     template<typename T>
-    void SparseMatrix<T>::insert(size_t index, size_t row, size_t col, T val)
+    template<typename S>
+    SparseMatrix<T> SparseMatrix<T>::multiply(const SparseMatrix<T> & m) const
     {
-        if (this->vals == nullptr) {
-            this->vals = new std::vector<T>(1, val);
-            this->cols = new std::vector<size_t>(1, col);
+        SPARSEMATRIX_STATS_TIME(MULTIPLY_MATRIX);
 
-        } else {
-            this->vals->insert(this->vals->begin() + index, val);
-            this->cols->insert(this->cols->begin() + index, col);
+        if (this->n != m.m) {
+            throw InvalidDimensionsException("Cannot multiply: Left matrix column count and right matrix row count don't match.");
         }
 
-        for (size_t i = row + 1; i <= this->m; i++) {
-            (*(this->rows))[i] += 1;
+        SparseMatrix<T> result(this->m, m.n);
+
+        if (this->vals == nullptr || m.vals == nullptr) { // product of empty matrix
+            return result;
         }
-    }
 
+        // row-by-row (Gustavson) product, rows are split between threads by estimated work
+        // @see http://www.math.tamu.edu/~srobertp/Courses/Math639_2014_Sp/CRSDescription/CRSStuff.pdf
 
-    template<typename T>
-    void SparseMatrix<T>::remove(size_t index, size_t row)
-    {
-        this->vals->erase(this->vals->begin() + index);
-        this->cols->erase(this->cols->begin() + index);
+        const size_t * leftRows = this->rows->data(), * leftCols = this->cols->data();
+        const size_t * rightRows = m.rows->data(), * rightCols = m.cols->data();
+        const T * leftVals = this->vals->data(), * rightVals = m.vals->data();
 
-        for (size_t i = row + 1; i <= this->m; i++) {
-            (*(this->rows))[i] -= 1;
-        }
-    }
+        std::vector<size_t> work(this->m + 1, 0);
 
+        for (size_t i = 0; i < this->m; i++) {
+            size_t flops = 0;
+            for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                flops += rightRows[leftCols[a] + 1] - rightRows[leftCols[a]];
+            }
 
-    // === FRIEND FUNCTIONS =========================================
+            work[i + 1] = work[i] + flops;
+        }
+
+        std::vector<size_t> bounds = Parallel::partition(work, work[this->m] < Parallel::MINIMUM_WORK ? 1 : Parallel::getThreadCount());
+
+        std::vector<size_t> partWork(bounds.size() - 1, 0); // largest row of each part sizes its accumulator
+        for (size_t p = 0; p + 1 < bounds.size(); p++) {
+            for (size_t i = bounds[p]; i < bounds[p + 1]; i++) {
+                partWork[p] = std::max(partWork[p], work[i + 1] - work[i]);
+            }
+        }
+
+        // symbolic phase - count distinct columns of every row
+
+        std::vector<size_t> rows(this->m + 1, 0);
+
+        Parallel::run(bounds, [&] (size_t part, size_t begin, size_t end) {
+            SparseAccumulator<T, S> accumulator(m.n, partWork[part]);
+
+            for (size_t i = begin; i < end; i++) {
+                accumulator.clear();
+
+                for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                    for (size_t b = rightRows[leftCols[a]]; b < rightRows[leftCols[a] + 1]; b++) {
+                        accumulator.mark(rightCols[b]);
+                    }
+                }
+
+                rows[i + 1] = accumulator.size();
+            }
+        });
+
+        for (size_t i = 0; i < this->m; i++) {
+            rows[i + 1] += rows[i];
+        }
+
+        // numeric phase - fill preallocated rows, elements equal to S::zero() are left out
+
+        std::vector<size_t> cols(rows[this->m]), kept(this->m);
+        std::vector<T> vals(rows[this->m]);
+
+        Parallel::run(bounds, [&] (size_t part, size_t begin, size_t end) {
+            SparseAccumulator<T, S> accumulator(m.n, partWork[part]);
+
+            for (size_t i = begin; i < end; i++) {
+                accumulator.clear();
+
+                for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                    const T & left = leftVals[a];
+
+                    for (size_t b = rightRows[leftCols[a]]; b < rightRows[leftCols[a] + 1]; b++) {
+                        accumulator.accumulate(rightCols[b], S::multiply(left, rightVals[b]));
+                    }
+                }
+
+                kept[i] = accumulator.gather(cols.data() + rows[i], vals.data() + rows[i]);
+            }
+        });
+
+        SparseMatrix<T>::compact(rows, cols, vals, kept); // close gaps left by elements which cancelled out
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::operator * (const SparseMatrix<T> & m) const
+    {
+        return this->multiply(m);
+    }
+
+
+    template<typename T>
+    template<typename S, typename X>
+    SparseMatrix<T> SparseMatrix<T>::multiplyMasked(const SparseMatrix<T> & m, const SparseMatrix<X> & mask, bool complement) const
+    {
+        SPARSEMATRIX_STATS_TIME(MULTIPLY_MATRIX);
+
+        if (this->n != m.m) {
+            throw InvalidDimensionsException("Cannot multiply: Left matrix column count and right matrix row count don't match.");
+        }
+
+        if (mask.m != this->m || mask.n != m.n) {
+            throw InvalidDimensionsException("Cannot multiply: Mask dimensions and product dimensions don't match.");
+        }
+
+        SparseMatrix<T> result(this->m, m.n);
+
+        if (this->getNnz() == 0 || m.getNnz() == 0 || (!complement && mask.getNnz() == 0)) {
+            return result;
+        }
+
+        const size_t * leftRows = this->rows->data(), * leftCols = this->cols->data();
+        const size_t * rightRows = m.rows->data(), * rightCols = m.cols->data();
+        const size_t * maskRows = mask.rows->data(), * maskCols = mask.getNnz() == 0 ? nullptr : mask.cols->data();
+        const T * leftVals = this->vals->data(), * rightVals = m.vals->data();
+
+        // a masked element can be computed as dot product of left row and right column (sorted intersection)
+        // rows where that is cheaper than accumulating the whole row use the transposed right matrix
+
+        std::vector<size_t> columnCounts(m.n, 0);
+        for (size_t b = 0; b < m.getNnz(); b++) {
+            columnCounts[rightCols[b]]++;
+        }
+
+        std::vector<size_t> work(this->m + 1, 0), flops(this->m, 0);
+        std::vector<char> useDot(this->m, 0);
+        bool anyDot = false;
+
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                flops[i] += rightRows[leftCols[a] + 1] - rightRows[leftCols[a]];
+            }
+
+            size_t cost = flops[i];
+
+            if (!complement) {
+                size_t dot = 0;
+                for (size_t c = maskRows[i]; c < maskRows[i + 1]; c++) {
+                    dot += leftRows[i + 1] - leftRows[i] + columnCounts[maskCols[c]];
+                }
+
+                if (dot < cost) {
+                    useDot[i] = 1;
+                    anyDot = true;
+                    cost = dot;
+                }
+            }
+
+            work[i + 1] = work[i] + cost;
+        }
+
+        std::vector<size_t> transposedRows, transposedCols;
+        std::vector<T> transposedVals;
+
+        if (anyDot) {
+            m.transposeInto(transposedRows, transposedCols, transposedVals);
+        }
+
+        std::vector<size_t> bounds = Parallel::partition(work, work[this->m] < Parallel::MINIMUM_WORK ? 1 : Parallel::getThreadCount());
+
+        std::vector<size_t> partWork(bounds.size() - 1, 0);
+        for (size_t p = 0; p + 1 < bounds.size(); p++) {
+            partWork[p] = *std::max_element(flops.begin() + bounds[p], flops.begin() + bounds[p + 1]);
+        }
+
+        // row sizes - mask row bounds the row, complemented mask needs symbolic phase
+
+        std::vector<size_t> rows(this->m + 1, 0);
+
+        if (!complement) {
+            for (size_t i = 0; i < this->m; i++) {
+                rows[i + 1] = maskRows[i + 1] - maskRows[i];
+            }
+
+        } else {
+            Parallel::run(bounds, [&] (size_t part, size_t begin, size_t end) {
+                SparseAccumulator<T, S> accumulator(m.n, partWork[part]);
+                std::vector<size_t> masked(m.n, 0);
+
+                for (size_t i = begin; i < end; i++) {
+                    for (size_t c = maskRows[i]; c < maskRows[i + 1]; c++) {
+                        masked[maskCols[c]] = i + 1;
+                    }
+
+                    accumulator.clear();
+
+                    for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                        for (size_t b = rightRows[leftCols[a]]; b < rightRows[leftCols[a] + 1]; b++) {
+                            if (masked[rightCols[b]] != i + 1) {
+                                accumulator.mark(rightCols[b]);
+                            }
+                        }
+                    }
+
+                    rows[i + 1] = accumulator.size();
+                }
+            });
+        }
+
+        for (size_t i = 0; i < this->m; i++) {
+            rows[i + 1] += rows[i];
+        }
+
+        // numeric phase
+
+        std::vector<size_t> cols(rows[this->m]), kept(this->m);
+        std::vector<T> vals(rows[this->m]);
+
+        Parallel::run(bounds, [&] (size_t part, size_t begin, size_t end) {
+            SparseAccumulator<T, S> accumulator(m.n, partWork[part]);
+            std::vector<size_t> masked(m.n, 0);
+
+            for (size_t i = begin; i < end; i++) {
+                if (useDot[i]) {
+                    size_t count = 0;
+
+                    for (size_t c = maskRows[i]; c < maskRows[i + 1]; c++) {
+                        size_t j = maskCols[c];
+                        size_t a = leftRows[i], b = transposedRows[j];
+                        T sum = S::zero();
+                        bool found = false;
+
+                        while (a < leftRows[i + 1] && b < transposedRows[j + 1]) {
+                            if (leftCols[a] < transposedCols[b]) {
+                                a++;
+
+                            } else if (transposedCols[b] < leftCols[a]) {
+                                b++;
+
+                            } else {
+                                sum = S::add(sum, S::multiply(leftVals[a], transposedVals[b]));
+                                found = true;
+                                a++;
+                                b++;
+                            }
+                        }
+
+                        if (found && !(sum == S::zero())) {
+                            cols[rows[i] + count] = j;
+                            vals[rows[i] + count] = sum;
+                            count++;
+                        }
+                    }
+
+                    kept[i] = count;
+                    continue;
+                }
+
+                for (size_t c = maskRows[i]; c < maskRows[i + 1]; c++) {
+                    masked[maskCols[c]] = i + 1;
+                }
+
+                accumulator.clear();
+
+                for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                    const T & left = leftVals[a];
+
+                    for (size_t b = rightRows[leftCols[a]]; b < rightRows[leftCols[a] + 1]; b++) {
+                        if ((masked[rightCols[b]] == i + 1) != complement) {
+                            accumulator.accumulate(rightCols[b], S::multiply(left, rightVals[b]));
+                        }
+                    }
+                }
+
+                kept[i] = accumulator.gather(cols.data() + rows[i], vals.data() + rows[i]);
+            }
+        });
+
+        SparseMatrix<T>::compact(rows, cols, vals, kept);
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::add(const SparseMatrix<T> & m) const
+    {
+        SPARSEMATRIX_STATS_TIME(ADD);
+
+        if (this->m != m.m || this->n != m.n) {
+            throw InvalidDimensionsException("Cannot add: matrices dimensions don't match.");
+        }
+
+        return this->merge(m, [] (const T & a, const T & b) { return a + b; });
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::operator + (const SparseMatrix<T> & m) const
+    {
+        return this->add(m);
+    }
+
+    template<typename T>
+    void SparseMatrix<T>::addSubmatrix(const SparseMatrix<T> & m)
+    {
+        if (this->m < m.m || this->n < m.n) {
+            throw InvalidDimensionsException("Cannot add submatrix with bigger dimension.");
+        }
+
+        for (size_t i = 0; i < m.m; i++) {
+            for (size_t j = 0; j < m.n; j++) {
+                this->set(this->get(i, j) + m.get(i, j), i, j);
+            }
+        }
+    }
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::subtract(const SparseMatrix<T> & m) const
+    {
+        SPARSEMATRIX_STATS_TIME(SUBTRACT);
+
+        if (this->m != m.m || this->n != m.n) {
+            throw InvalidDimensionsException("Cannot subtract: matrices dimensions don't match.");
+        }
+
+        return this->merge(m, [] (const T & a, const T & b) { return a - b; });
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::operator - (const SparseMatrix<T> & m) const
+    {
+        return this->subtract(m);
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::transpose(void) const
+    {
+        SparseMatrix<T> result(this->n, this->m);
+
+        std::vector<size_t> rows, cols;
+        std::vector<T> vals;
+
+        this->transposeInto(rows, cols, vals);
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+
+        return result;
+    }
+
+
+    // === NUMERIC OPERATIONS ==============================================
+
+    template<typename T>
+    template<typename S>
+    void SparseMatrix<T>::multiplyInto(const SparseMatrix<T> & m, SparseMatrix<T> & result) const
+    {
+        SPARSEMATRIX_STATS_TIME(MULTIPLY_MATRIX);
+
+        if (this->n != m.m) {
+            throw InvalidDimensionsException("Cannot multiply: Left matrix column count and right matrix row count don't match.");
+        }
+
+        if (result.m != this->m || result.n != m.n) {
+            throw InvalidDimensionsException("Cannot multiply: Result dimensions and product dimensions don't match.");
+        }
+
+        // values are computed aside, so result may be one of the operands and stays intact on failure
+        std::vector<T> vals(result.getNnz(), S::zero());
+
+        if (this->getNnz() != 0 && m.getNnz() != 0) {
+            const size_t * leftRows = this->rows->data(), * leftCols = this->cols->data();
+            const size_t * rightRows = m.rows->data(), * rightCols = m.cols->data();
+            const size_t * resultRows = result.rows->data(), * resultCols = result.getNnz() == 0 ? nullptr : result.cols->data();
+            const T * leftVals = this->vals->data(), * rightVals = m.vals->data();
+
+            std::vector<size_t> work(this->m + 1, 0);
+            for (size_t i = 0; i < this->m; i++) {
+                work[i + 1] = work[i];
+                for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                    work[i + 1] += rightRows[leftCols[a] + 1] - rightRows[leftCols[a]];
+                }
+            }
+
+            std::vector<size_t> bounds = Parallel::partition(work, work.back() < Parallel::MINIMUM_WORK ? 1 : Parallel::getThreadCount());
+
+            Parallel::run(bounds, [&] (size_t, size_t firstRow, size_t lastRow) {
+                const size_t missing = static_cast<size_t>(-1);
+
+                // narrow results map columns to positions directly, wide ones search the sorted row
+                bool dense = result.n <= SparseAccumulator<T, S>::DENSE_LIMIT;
+                std::vector<size_t> position(dense ? result.n : 0, missing);
+
+                for (size_t i = firstRow; i < lastRow; i++) {
+                    const size_t * rowBegin = resultCols + resultRows[i], * rowEnd = resultCols + resultRows[i + 1];
+
+                    if (dense) {
+                        for (const size_t * c = rowBegin; c != rowEnd; c++) {
+                            position[*c] = c - resultCols;
+                        }
+                    }
+
+                    for (size_t a = leftRows[i]; a < leftRows[i + 1]; a++) {
+                        size_t k = leftCols[a];
+
+                        for (size_t b = rightRows[k]; b < rightRows[k + 1]; b++) {
+                            size_t pos = missing;
+
+                            if (dense) {
+                                pos = position[rightCols[b]];
+
+                            } else {
+                                const size_t * c = std::lower_bound(rowBegin, rowEnd, rightCols[b]);
+                                pos = (c != rowEnd && *c == rightCols[b]) ? c - resultCols : missing;
+                            }
+
+                            if (pos == missing) {
+                                throw InvalidArgumentException("Cannot multiply: Result pattern doesn't contain the product pattern.");
+                            }
+
+                            vals[pos] = S::add(vals[pos], S::multiply(leftVals[a], rightVals[b]));
+                        }
+                    }
+
+                    if (dense) {
+                        for (const size_t * c = rowBegin; c != rowEnd; c++) {
+                            position[*c] = missing;
+                        }
+                    }
+                }
+            });
+        }
+
+        // zeros are kept, so that the next step finds the same pattern
+        result.replaceValues(std::move(vals));
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::addInto(const SparseMatrix<T> & m, SparseMatrix<T> & result) const
+    {
+        SPARSEMATRIX_STATS_TIME(ADD);
+
+        if (this->m != m.m || this->n != m.n || result.m != this->m || result.n != this->n) {
+            throw InvalidDimensionsException("Cannot add: matrices dimensions don't match.");
+        }
+
+        std::vector<T> vals(result.getNnz(), T());
+
+        Parallel::parallelFor(*(result.rows), [&] (size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < lastRow; i++) {
+                size_t a = (*(this->rows))[i], aEnd = (*(this->rows))[i + 1];
+                size_t b = (*(m.rows))[i], bEnd = (*(m.rows))[i + 1];
+
+                // walk the result row and pick matching elements of both operands
+                for (size_t pos = (*(result.rows))[i]; pos < (*(result.rows))[i + 1]; pos++) {
+                    size_t col = (*(result.cols))[pos];
+
+                    if ((a < aEnd && (*(this->cols))[a] < col) || (b < bEnd && (*(m.cols))[b] < col)) {
+                        break; // element missing in the result pattern, reported below
+                    }
+
+                    if (a < aEnd && (*(this->cols))[a] == col) {
+                        vals[pos] = vals[pos] + (*(this->vals))[a++];
+                    }
+
+                    if (b < bEnd && (*(m.cols))[b] == col) {
+                        vals[pos] = vals[pos] + (*(m.vals))[b++];
+                    }
+                }
+
+                if (a < aEnd || b < bEnd) {
+                    throw InvalidArgumentException("Cannot add: Result pattern doesn't contain the sum pattern.");
+                }
+            }
+        });
+
+        result.replaceValues(std::move(vals));
+    }
+
+
+    // === IN-PLACE OPERATIONS ==============================================
+
+    template<typename T>
+    SparseMatrix<T> & SparseMatrix<T>::scale(const T & alpha)
+    {
+        if (alpha == T() && this->pattern == nullptr) {
+            this->assign(std::vector<size_t>(this->m + 1, 0), std::vector<size_t>(), std::vector<T>());
+            return *this;
+        }
+
+        return this->apply([&alpha] (const T & val) { return alpha * val; });
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> & SparseMatrix<T>::axpy(const T & alpha, const SparseMatrix<T> & m)
+    {
+        if (this->m != m.m || this->n != m.n) {
+            throw InvalidDimensionsException("Cannot add: matrices dimensions don't match.");
+        }
+
+        if (m.getNnz() == 0 || alpha == T()) {
+            return *this;
+        }
+
+        if (this->hasSamePattern(m)) { // straight over the values
+            this->detachValues();
+
+            T * values = this->vals->data();
+            const T * other = m.vals->data();
+
+            for (size_t pos = 0, nnz = this->getNnz(); pos < nnz; pos++) {
+                values[pos] = values[pos] + alpha * other[pos];
+            }
+
+            this->prune();
+            return *this;
+        }
+
+        if (this->containsPattern(m)) { // m fits into the pattern, only values of this change
+            this->detachValues();
+
+            for (size_t i = 0; i < this->m; i++) {
+                size_t a = (*(this->rows))[i];
+
+                for (size_t b = (*(m.rows))[i]; b < (*(m.rows))[i + 1]; b++) {
+                    while ((*(this->cols))[a] != (*(m.cols))[b]) {
+                        a++;
+                    }
+
+                    (*(this->vals))[a] = (*(this->vals))[a] + alpha * (*(m.vals))[b];
+                }
+            }
+
+            this->prune();
+            return *this;
+        }
+
+        // merge rows of both patterns
+
+        std::vector<size_t> rows(this->m + 1, 0), cols;
+        std::vector<T> vals;
+
+        cols.reserve(this->getNnz() + m.getNnz());
+        vals.reserve(this->getNnz() + m.getNnz());
+
+        for (size_t i = 0; i < this->m; i++) {
+            size_t a = (*(this->rows))[i], aEnd = (*(this->rows))[i + 1];
+            size_t b = (*(m.rows))[i], bEnd = (*(m.rows))[i + 1];
+
+            while (a < aEnd || b < bEnd) {
+                size_t left = a < aEnd ? (*(this->cols))[a] : this->n;
+                size_t right = b < bEnd ? (*(m.cols))[b] : this->n;
+                T val;
+
+                if (left < right) {
+                    val = (*(this->vals))[a++];
+
+                } else if (right < left) {
+                    val = alpha * (*(m.vals))[b++];
+
+                } else {
+                    val = (*(this->vals))[a++] + alpha * (*(m.vals))[b++];
+                }
+
+                if (!(val == T())) {
+                    cols.push_back(std::min(left, right));
+                    vals.push_back(val);
+                }
+            }
+
+            rows[i + 1] = cols.size();
+        }
+
+        this->assign(std::move(rows), std::move(cols), std::move(vals));
+        return *this;
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> & SparseMatrix<T>::hadamard(const SparseMatrix<T> & m)
+    {
+        if (this->m != m.m || this->n != m.n) {
+            throw InvalidDimensionsException("Cannot multiply element-wise: matrices dimensions don't match.");
+        }
+
+        if (this->getNnz() == 0) {
+            return *this;
+        }
+
+        if (m.getNnz() == 0) {
+            return this->scale(T());
+        }
+
+        this->detachValues();
+
+        if (this->hasSamePattern(m)) {
+            T * values = this->vals->data();
+            const T * other = m.vals->data();
+
+            for (size_t pos = 0, nnz = this->getNnz(); pos < nnz; pos++) {
+                values[pos] = values[pos] * other[pos];
+            }
+
+            this->prune();
+            return *this;
+        }
+
+        // result pattern is a subset of this one, entries missing in m become zero
+        for (size_t i = 0; i < this->m; i++) {
+            size_t b = (*(m.rows))[i], bEnd = (*(m.rows))[i + 1];
+
+            for (size_t a = (*(this->rows))[i]; a < (*(this->rows))[i + 1]; a++) {
+                size_t col = (*(this->cols))[a];
+
+                while (b < bEnd && (*(m.cols))[b] < col) {
+                    b++;
+                }
+
+                (*(this->vals))[a] = (b < bEnd && (*(m.cols))[b] == col) ? (*(this->vals))[a] * (*(m.vals))[b] : T();
+            }
+        }
+
+        this->prune();
+        return *this;
+    }
+
+
+    template<typename T>
+    template<typename F>
+    SparseMatrix<T> & SparseMatrix<T>::apply(F f)
+    {
+        if (this->getNnz() == 0) {
+            return *this;
+        }
+
+        this->detachValues();
+
+        T * values = this->vals->data();
+
+        for (size_t pos = 0, nnz = this->getNnz(); pos < nnz; pos++) {
+            values[pos] = f(values[pos]);
+        }
+
+        this->prune();
+        return *this;
+    }
+
+
+    // === REDUCTIONS ==============================================
+
+    template<typename T>
+    std::vector<T> SparseMatrix<T>::rowSums(void) const
+    {
+        return this->reduceRows([] (const T * values, size_t count) {
+            return Reductions::reduce(values, count, T(), Reductions::Identity(), Reductions::Plus());
+        });
+    }
+
+
+    template<typename T>
+    std::vector<T> SparseMatrix<T>::columnSums(void) const
+    {
+        return this->sumColumns(Reductions::Identity());
+    }
+
+
+    template<typename T>
+    std::vector<T> SparseMatrix<T>::rowNorms(Norm norm) const
+    {
+        switch (norm) {
+            case NORM_1:
+                return this->reduceRows([] (const T * values, size_t count) {
+                    return Reductions::reduce(values, count, T(), Reductions::Absolute(), Reductions::Plus());
+                });
+
+            case NORM_INF:
+                return this->reduceRows([] (const T * values, size_t count) {
+                    return Reductions::reduce(values, count, T(), Reductions::Absolute(), Reductions::Maximum());
+                });
+
+            default: // rows are vectors, so their Frobenius and Euclidean norms are the same
+                return this->reduceRows([] (const T * values, size_t count) {
+                    return static_cast<T>(std::sqrt(Reductions::reduce(values, count, T(), Reductions::Square(), Reductions::Plus())));
+                });
+        }
+    }
+
+
+    template<typename T>
+    T SparseMatrix<T>::norm(Norm norm) const
+    {
+        switch (norm) {
+            case NORM_1: {
+                std::vector<T> sums = this->sumColumns(Reductions::Absolute());
+                return Reductions::reduce(sums.data(), sums.size(), T(), Reductions::Identity(), Reductions::Maximum());
+            }
+
+            case NORM_INF: {
+                std::vector<T> sums = this->rowNorms(NORM_1);
+                return Reductions::reduce(sums.data(), sums.size(), T(), Reductions::Identity(), Reductions::Maximum());
+            }
+
+            case NORM_FROBENIUS:
+                return static_cast<T>(std::sqrt(this->reduceAll(T(), Reductions::Square(), Reductions::Plus())));
+
+            default:
+                throw InvalidArgumentException("Spectral norm is not a reduction, use NORM_FROBENIUS as its upper bound.");
+        }
+    }
+
+
+    template<typename T>
+    T SparseMatrix<T>::min(void) const
+    {
+        if (this->getNnz() == 0) {
+            return T();
+        }
+
+        T result = this->reduceAll((*(this->vals))[0], Reductions::Identity(), Reductions::Minimum());
+
+        // implicit zeros take part if there are any (nnz < m * n without overflow)
+        return this->getNnz() / this->n < this->m ? Reductions::Minimum()(result, T()) : result;
+    }
+
+
+    template<typename T>
+    T SparseMatrix<T>::max(void) const
+    {
+        if (this->getNnz() == 0) {
+            return T();
+        }
+
+        T result = this->reduceAll((*(this->vals))[0], Reductions::Identity(), Reductions::Maximum());
+
+        return this->getNnz() / this->n < this->m ? Reductions::Maximum()(result, T()) : result;
+    }
+
+
+    template<typename T>
+    std::vector<size_t> SparseMatrix<T>::rowNnz(void) const
+    {
+        std::vector<size_t> result(this->m);
+
+        for (size_t i = 0; i < this->m; i++) {
+            result[i] = (*(this->rows))[i + 1] - (*(this->rows))[i];
+        }
+
+        return result;
+    }
+
+
+    template<typename T>
+    std::vector<T> SparseMatrix<T>::diagonal(void) const
+    {
+        size_t count = std::min(this->m, this->n);
+        std::vector<T> result(count, T());
+
+        if (this->getNnz() == 0) {
+            return result;
+        }
+
+        const size_t * rowPtr = this->rows->data();
+        const size_t * colIdx = this->cols->data();
+        const T * values = this->vals->data();
+
+        Parallel::parallelFor(*(this->rows), [&] (size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < std::min(lastRow, count); i++) {
+                const size_t * it = std::lower_bound(colIdx + rowPtr[i], colIdx + rowPtr[i + 1], i);
+
+                if (it != colIdx + rowPtr[i + 1] && *it == i) {
+                    result[i] = values[it - colIdx];
+                }
+            }
+        });
+
+        return result;
+    }
+
+
+    // === COMPOSITION ==============================================
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::vstack(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks)
+    {
+        std::vector<std::vector<const SparseMatrix<T> *> > grid;
+
+        for (const SparseMatrix<T> & matrix : blocks) {
+            grid.push_back(std::vector<const SparseMatrix<T> *>(1, &matrix));
+        }
+
+        return SparseMatrix<T>::block(grid);
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::hstack(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks)
+    {
+        std::vector<std::vector<const SparseMatrix<T> *> > grid(1);
+
+        for (const SparseMatrix<T> & matrix : blocks) {
+            grid[0].push_back(&matrix);
+        }
+
+        return SparseMatrix<T>::block(grid);
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::blockDiag(const std::vector<std::reference_wrapper<const SparseMatrix<T> > > & blocks)
+    {
+        std::vector<std::vector<const SparseMatrix<T> *> > grid(blocks.size(), std::vector<const SparseMatrix<T> *>(blocks.size(), nullptr));
+
+        for (size_t b = 0; b < blocks.size(); b++) {
+            grid[b][b] = &blocks[b].get();
+        }
+
+        return SparseMatrix<T>::block(grid);
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::block(const std::vector<std::vector<const SparseMatrix<T> *> > & blocks)
+    {
+        size_t blockRows = blocks.size();
+        size_t blockCols = blockRows == 0 ? 0 : blocks[0].size();
+
+        if (blockCols == 0) {
+            throw InvalidDimensionsException("Cannot compose: no blocks given.");
+        }
+
+        // every block row / column needs at least one block telling its size, others have to agree
+
+        std::vector<size_t> heights(blockRows, 0), widths(blockCols, 0);
+
+        for (size_t r = 0; r < blockRows; r++) {
+            if (blocks[r].size() != blockCols) {
+                throw InvalidDimensionsException("Cannot compose: block rows have different block counts.");
+            }
+
+            for (size_t c = 0; c < blockCols; c++) {
+                const SparseMatrix<T> * matrix = blocks[r][c];
+
+                if (matrix == nullptr) {
+                    continue;
+                }
+
+                if ((heights[r] != 0 && heights[r] != matrix->m) || (widths[c] != 0 && widths[c] != matrix->n)) {
+                    throw InvalidDimensionsException("Cannot compose: blocks dimensions don't match.");
+                }
+
+                heights[r] = matrix->m;
+                widths[c] = matrix->n;
+            }
+        }
+
+        if (std::find(heights.begin(), heights.end(), 0) != heights.end() || std::find(widths.begin(), widths.end(), 0) != widths.end()) {
+            throw InvalidDimensionsException("Cannot compose: block row or column without any block.");
+        }
+
+        std::vector<size_t> rowOffsets(blockRows + 1, 0), colOffsets(blockCols + 1, 0);
+        std::partial_sum(heights.begin(), heights.end(), rowOffsets.begin() + 1);
+        std::partial_sum(widths.begin(), widths.end(), colOffsets.begin() + 1);
+
+        SparseMatrix<T> result(rowOffsets[blockRows], colOffsets[blockCols]);
+
+        // row pointers by prefix sum of row lengths
+
+        std::vector<size_t> rows(result.m + 1, 0);
+
+        for (size_t r = 0; r < blockRows; r++) {
+            for (size_t c = 0; c < blockCols; c++) {
+                const SparseMatrix<T> * matrix = blocks[r][c];
+
+                for (size_t i = 0; matrix != nullptr && i < matrix->m; i++) {
+                    rows[rowOffsets[r] + i + 1] += (*(matrix->rows))[i + 1] - (*(matrix->rows))[i];
+                }
+            }
+        }
+
+        for (size_t i = 0; i < result.m; i++) {
+            rows[i + 1] += rows[i];
+        }
+
+        // copy row segments, blocks to the right follow with shifted columns
+
+        std::vector<size_t> cols(rows[result.m]);
+        std::vector<T> vals(rows[result.m]);
+
+        Parallel::parallelFor(rows, [&] (size_t firstRow, size_t lastRow) {
+            size_t r = std::upper_bound(rowOffsets.begin(), rowOffsets.end(), firstRow) - rowOffsets.begin() - 1;
+
+            for (size_t row = firstRow; row < lastRow; row++) {
+                while (row >= rowOffsets[r + 1]) {
+                    r++;
+                }
+
+                size_t i = row - rowOffsets[r];
+                size_t pos = rows[row];
+
+                for (size_t c = 0; c < blockCols; c++) {
+                    const SparseMatrix<T> * matrix = blocks[r][c];
+
+                    if (matrix == nullptr) {
+                        continue;
+                    }
+
+                    for (size_t src = (*(matrix->rows))[i]; src < (*(matrix->rows))[i + 1]; src++, pos++) {
+                        cols[pos] = (*(matrix->cols))[src] + colOffsets[c];
+                        vals[pos] = (*(matrix->vals))[src];
+                    }
+                }
+            }
+        });
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrix<T>::kron(const SparseMatrix<T> & a, const SparseMatrix<T> & b)
+    {
+        SparseMatrix<T> result(a.m * b.m, a.n * b.n);
+
+        if (a.getNnz() == 0 || b.getNnz() == 0) {
+            return result;
+        }
+
+        std::vector<size_t> rows(result.m + 1, 0), cols;
+        std::vector<T> vals;
+
+        cols.reserve(a.getNnz() * b.getNnz());
+        vals.reserve(a.getNnz() * b.getNnz());
+
+        for (size_t ia = 0; ia < a.m; ia++) {
+            for (size_t ib = 0; ib < b.m; ib++) {
+                for (size_t pa = (*(a.rows))[ia]; pa < (*(a.rows))[ia + 1]; pa++) {
+                    size_t colOffset = (*(a.cols))[pa] * b.n;
+                    const T & left = (*(a.vals))[pa];
+
+                    for (size_t pb = (*(b.rows))[ib]; pb < (*(b.rows))[ib + 1]; pb++) {
+                        T val = left * (*(b.vals))[pb];
+
+                        if (!(val == T())) {
+                            cols.push_back(colOffset + (*(b.cols))[pb]);
+                            vals.push_back(val);
+                        }
+                    }
+                }
+
+                rows[ia * b.m + ib + 1] = cols.size();
+            }
+        }
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    // === CAPACITY ==============================================
+
+    template<typename T>
+    void SparseMatrix<T>::reserve(size_t nnz)
+    {
+        this->detachStructure();
+        this->detachValues();
+
+        if (this->vals == nullptr) {
+            this->vals = std::make_shared<std::vector<T> >();
+            this->cols = std::make_shared<std::vector<size_t> >();
+        }
+
+        #ifdef SPARSEMATRIX_STATS
+            size_t capacity = this->vals->capacity();
+        #endif
+
+        this->vals->reserve(nnz);
+        this->cols->reserve(nnz);
+
+        SPARSEMATRIX_STATS_ALLOCATED((this->vals->capacity() - capacity) * (sizeof(T) + sizeof(size_t)));
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::reserve(const std::vector<size_t> & rowCapacities)
+    {
+        if (rowCapacities.size() != this->m) {
+            throw InvalidDimensionsException("Cannot reserve: capacity count and matrix row count don't match.");
+        }
+
+        // rows share one array, so the hints only add up to its total capacity
+        size_t nnz = 0;
+
+        for (size_t i = 0; i < this->m; i++) {
+            nnz += std::max(rowCapacities[i], (*(this->rows))[i + 1] - (*(this->rows))[i]);
+        }
+
+        this->reserve(nnz);
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::shrinkToFit(void)
+    {
+        // shared pattern or arrays shared with copies are not ours to shrink
+        if (this->vals == nullptr || this->pattern != nullptr || this->isShared() || this->rows.use_count() > 1) {
+            return ;
+        }
+
+        if (this->vals->empty()) {
+            this->vals = nullptr;
+            this->cols = nullptr;
+
+        } else {
+            this->vals->shrink_to_fit();
+            this->cols->shrink_to_fit();
+        }
+    }
+
+
+    template<typename T>
+    typename SparseMatrix<T>::MemoryUsage SparseMatrix<T>::memoryUsage(void) const
+    {
+        MemoryUsage usage;
+
+        usage.rows = this->rows->capacity() * sizeof(size_t);
+        usage.cols = this->cols == nullptr ? 0 : this->cols->capacity() * sizeof(size_t);
+        usage.vals = this->vals == nullptr ? 0 : this->vals->capacity() * sizeof(T);
+        usage.total = sizeof(*this) + usage.rows + usage.cols + usage.vals;
+
+        return usage;
+    }
+
+
+    // === SNAPSHOTS ==============================================
+
+    template<typename T>
+    std::shared_ptr<const SparseMatrix<T> > SparseMatrix<T>::freeze(void) const
+    {
+        return std::make_shared<const SparseMatrix<T> >(*this);
+    }
+
+
+    // === HELPERS / VALIDATORS ==============================================
+
+    template<typename T>
+    void SparseMatrix<T>::detachStructure(void)
+    {
+        // arrays of a pattern are aliases, so they are never owned alone
+        bool shared = this->pattern != nullptr || this->rows.use_count() > 1 || (this->cols != nullptr && this->cols.use_count() > 1);
+
+        if (!shared) {
+            // use_count() is a relaxed load - order the writes after reads of a copy released by another thread
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return ;
+        }
+
+        // copy the structure before changing it, the pattern or the copies sharing it stay untouched
+        this->rows = std::make_shared<std::vector<size_t> >(*(this->rows));
+        SPARSEMATRIX_STATS_ALLOCATED(this->rows->size() * sizeof(size_t));
+
+        if (this->cols != nullptr) {
+            this->cols = std::make_shared<std::vector<size_t> >(*(this->cols));
+            SPARSEMATRIX_STATS_ALLOCATED(this->cols->size() * sizeof(size_t));
+        }
+
+        this->pattern.reset();
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::detachValues(void)
+    {
+        if (this->isShared()) {
+            this->vals = std::make_shared<std::vector<T> >(*(this->vals));
+            SPARSEMATRIX_STATS_ALLOCATED(this->vals->size() * sizeof(T));
+
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire); // see detachStructure()
+        }
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::validateCoordinates(size_t row, size_t col) const
+    {
+        if (row < 0 || col < 0 || row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::insert(size_t index, size_t row, size_t col, T val)
+    {
+        SPARSEMATRIX_STATS_TIME(INSERT);
+
+        this->detachStructure();
+        this->detachValues();
+
+        if (this->vals == nullptr) {
+            this->vals = std::make_shared<std::vector<T> >(1, val);
+            this->cols = std::make_shared<std::vector<size_t> >(1, col);
+            SPARSEMATRIX_STATS_ALLOCATED(sizeof(T) + sizeof(size_t));
+
+        } else {
+            #ifdef SPARSEMATRIX_STATS
+                size_t capacity = this->vals->capacity();
+            #endif
+
+            this->vals->insert(this->vals->begin() + index, val);
+            this->cols->insert(this->cols->begin() + index, col);
+
+            SPARSEMATRIX_STATS_SHIFTED(INSERT, this->vals->size() - 1 - index);
+            SPARSEMATRIX_STATS_ALLOCATED((this->vals->capacity() - capacity) * (sizeof(T) + sizeof(size_t)));
+        }
+
+        for (size_t i = row + 1; i <= this->m; i++) {
+            (*(this->rows))[i] += 1;
+        }
+
+        SPARSEMATRIX_STATS_NNZ(this->vals->size());
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::remove(size_t index, size_t row)
+    {
+        SPARSEMATRIX_STATS_TIME(REMOVE);
+
+        this->detachStructure();
+        this->detachValues();
+
+        this->vals->erase(this->vals->begin() + index);
+        this->cols->erase(this->cols->begin() + index);
+        SPARSEMATRIX_STATS_SHIFTED(REMOVE, this->vals->size() - index);
+
+        for (size_t i = row + 1; i <= this->m; i++) {
+            (*(this->rows))[i] -= 1;
+        }
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::assign(std::vector<size_t> && rows, std::vector<size_t> && cols, std::vector<T> && vals)
+    {
+        // new arrays replace the old ones, a shared pattern or copies keep theirs
+        this->pattern.reset();
+        this->rows = std::make_shared<std::vector<size_t> >(std::move(rows));
+
+        if (vals.empty()) {
+            this->vals = nullptr;
+            this->cols = nullptr;
+
+        } else {
+            this->vals = std::make_shared<std::vector<T> >(std::move(vals));
+            this->cols = std::make_shared<std::vector<size_t> >(std::move(cols));
+            SPARSEMATRIX_STATS_ALLOCATED(this->vals->capacity() * sizeof(T) + this->cols->capacity() * sizeof(size_t));
+            SPARSEMATRIX_STATS_NNZ(this->vals->size());
+        }
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::replaceValues(std::vector<T> && values)
+    {
+        if (values.empty()) {
+            return ;
+        }
+
+        if (this->isShared()) { // new array instead of cloning the old values
+            this->vals = std::make_shared<std::vector<T> >(std::move(values));
+            SPARSEMATRIX_STATS_ALLOCATED(this->vals->size() * sizeof(T));
+
+        } else {
+            *(this->vals) = std::move(values);
+        }
+    }
+
+
+    template<typename T>
+    bool SparseMatrix<T>::hasSamePattern(const SparseMatrix<T> & m) const
+    {
+        if (this->rows == m.rows) { // shared pattern
+            return true;
+        }
+
+        if (this->getNnz() != m.getNnz()) {
+            return false;
+        }
+
+        return this->getNnz() == 0 || (*(this->rows) == *(m.rows) && *(this->cols) == *(m.cols));
+    }
+
+
+    template<typename T>
+    bool SparseMatrix<T>::containsPattern(const SparseMatrix<T> & m) const
+    {
+        if (m.getNnz() == 0) {
+            return true;
+        }
+
+        if (this->getNnz() < m.getNnz()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < this->m; i++) {
+            size_t a = (*(this->rows))[i], aEnd = (*(this->rows))[i + 1];
+
+            for (size_t b = (*(m.rows))[i]; b < (*(m.rows))[i + 1]; b++) {
+                while (a < aEnd && (*(this->cols))[a] < (*(m.cols))[b]) {
+                    a++;
+                }
+
+                if (a == aEnd || (*(this->cols))[a] != (*(m.cols))[b]) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::prune(void)
+    {
+        if (this->pattern != nullptr) { // zeros stay stored so that the pattern remains shared
+            return ;
+        }
+
+        size_t nnz = this->getNnz();
+        const T * values = nnz == 0 ? nullptr : this->vals->data();
+
+        size_t first = 0;
+        while (first < nnz && !(values[first] == T())) {
+            first++;
+        }
+
+        if (first == nnz) { // nothing to remove
+            return ;
+        }
+
+        this->detachStructure();
+        this->detachValues();
+
+        // drop elements which became zero
+        size_t pos = 0, row = 0;
+
+        for (size_t src = 0; src < nnz; src++) {
+            while ((*(this->rows))[row + 1] <= src) {
+                (*(this->rows))[++row] = pos;
+            }
+
+            if (!((*(this->vals))[src] == T())) {
+                (*(this->cols))[pos] = (*(this->cols))[src];
+                (*(this->vals))[pos] = (*(this->vals))[src];
+                pos++;
+            }
+        }
+
+        while (row < this->m) {
+            (*(this->rows))[++row] = pos;
+        }
+
+        this->cols->resize(pos);
+        this->vals->resize(pos);
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::transposeInto(std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals) const
+    {
+        size_t nnz = this->getNnz();
+
+        // counting sort by column keeps row indices sorted within each column
+        rows.assign(this->n + 1, 0);
+        cols.resize(nnz);
+        vals.resize(nnz);
+
+        // every part of rows counts its columns separately, so the parts can scatter independently;
+        // the counters cost n per part, which limits parts by the average column length
+        size_t parts = nnz < Parallel::MINIMUM_WORK ? 1 : std::min(Parallel::getThreadCount(), nnz / this->n);
+        std::vector<size_t> bounds = Parallel::partition(*(this->rows), parts);
+        parts = bounds.size() - 1;
+
+        std::vector<std::vector<size_t> > next(parts);
+
+        Parallel::run(bounds, [&] (size_t part, size_t firstRow, size_t lastRow) {
+            next[part].assign(this->n, 0);
+
+            for (size_t pos = (*(this->rows))[firstRow]; pos < (*(this->rows))[lastRow]; pos++) {
+                next[part][(*(this->cols))[pos]]++;
+            }
+        });
+
+        // turn counts into positions - column by column, parts in row order
+        size_t offset = 0;
+
+        for (size_t j = 0; j < this->n; j++) {
+            for (size_t part = 0; part < parts; part++) {
+                size_t count = next[part][j];
+                next[part][j] = offset;
+                offset += count;
+            }
+
+            rows[j + 1] = offset;
+        }
+
+        Parallel::run(bounds, [&] (size_t part, size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < lastRow; i++) {
+                for (size_t pos = (*(this->rows))[i]; pos < (*(this->rows))[i + 1]; pos++) {
+                    size_t target = next[part][(*(this->cols))[pos]]++;
+
+                    cols[target] = i;
+                    vals[target] = (*(this->vals))[pos];
+                }
+            }
+        });
+    }
+
+
+    template<typename T>
+    template<typename F>
+    SparseMatrix<T> SparseMatrix<T>::merge(const SparseMatrix<T> & m, F f) const
+    {
+        SparseMatrix<T> result(this->m, this->n);
+
+        // rows are sized for both operands, gaps of shared columns and zero results are closed afterwards
+        std::vector<size_t> rows(this->m + 1);
+
+        for (size_t i = 0; i <= this->m; i++) {
+            rows[i] = (*(this->rows))[i] + (*(m.rows))[i];
+        }
+
+        if (rows[this->m] == 0) {
+            return result;
+        }
+
+        std::vector<size_t> cols(rows[this->m]), kept(this->m);
+        std::vector<T> vals(rows[this->m]);
+
+        Parallel::parallelFor(rows, [&] (size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < lastRow; i++) {
+                size_t a = (*(this->rows))[i], aEnd = (*(this->rows))[i + 1];
+                size_t b = (*(m.rows))[i], bEnd = (*(m.rows))[i + 1];
+                size_t pos = rows[i];
+
+                while (a < aEnd || b < bEnd) {
+                    size_t colA = a < aEnd ? (*(this->cols))[a] : this->n;
+                    size_t colB = b < bEnd ? (*(m.cols))[b] : this->n;
+                    size_t col = std::min(colA, colB);
+
+                    T val = f(colA == col ? (*(this->vals))[a++] : T(), colB == col ? (*(m.vals))[b++] : T());
+
+                    if (!(val == T())) {
+                        cols[pos] = col;
+                        vals[pos] = val;
+                        pos++;
+                    }
+                }
+
+                kept[i] = pos - rows[i];
+            }
+        });
+
+        SparseMatrix<T>::compact(rows, cols, vals, kept);
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    template<typename T>
+    void SparseMatrix<T>::compact(std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals, const std::vector<size_t> & kept)
+    {
+        size_t m = kept.size();
+
+        if (std::accumulate(kept.begin(), kept.end(), static_cast<size_t>(0)) == rows[m]) {
+            return ;
+        }
+
+        size_t pos = 0;
+
+        for (size_t i = 0; i < m; i++) {
+            std::move(cols.begin() + rows[i], cols.begin() + rows[i] + kept[i], cols.begin() + pos);
+            std::move(vals.begin() + rows[i], vals.begin() + rows[i] + kept[i], vals.begin() + pos);
+
+            rows[i] = pos;
+            pos += kept[i];
+        }
+
+        rows[m] = pos;
+        cols.resize(pos);
+        vals.resize(pos);
+    }
+
+
+    template<typename T>
+    template<typename F>
+    std::vector<T> SparseMatrix<T>::reduceRows(F f) const
+    {
+        std::vector<T> result(this->m, T());
+
+        if (this->getNnz() == 0) {
+            return result;
+        }
+
+        const size_t * rowPtr = this->rows->data();
+        const T * values = this->vals->data();
+
+        Parallel::parallelFor(*(this->rows), [&] (size_t firstRow, size_t lastRow) {
+            for (size_t i = firstRow; i < lastRow; i++) {
+                result[i] = f(values + rowPtr[i], rowPtr[i + 1] - rowPtr[i]);
+            }
+        });
+
+        return result;
+    }
+
+
+    template<typename T>
+    template<typename F, typename Op>
+    T SparseMatrix<T>::reduceAll(const T & identity, F f, Op op) const
+    {
+        size_t nnz = this->getNnz();
+
+        if (nnz == 0) {
+            return identity;
+        }
+
+        // every part reduces a contiguous range of values, partial results are combined in part order
+        std::vector<size_t> bounds = Parallel::partition(*(this->rows), nnz < Parallel::MINIMUM_WORK ? 1 : Parallel::getThreadCount());
+        std::vector<T> partial(bounds.size() - 1, identity);
+
+        const size_t * rowPtr = this->rows->data();
+        const T * values = this->vals->data();
+
+        Parallel::run(bounds, [&] (size_t part, size_t firstRow, size_t lastRow) {
+            partial[part] = Reductions::reduce(values + rowPtr[firstRow], rowPtr[lastRow] - rowPtr[firstRow], identity, f, op);
+        });
+
+        T result = identity;
+
+        for (const T & value : partial) {
+            result = op(result, value);
+        }
+
+        return result;
+    }
+
+
+    template<typename T>
+    template<typename F>
+    std::vector<T> SparseMatrix<T>::sumColumns(F f) const
+    {
+        size_t nnz = this->getNnz();
+        std::vector<T> result(this->n, T());
+
+        if (nnz == 0) {
+            return result;
+        }
+
+        // every part sums into its own columns, which costs n per part - parts are limited by the average column length
+        size_t parts = nnz < Parallel::MINIMUM_WORK ? 1 : std::min(Parallel::getThreadCount(), nnz / this->n);
+        std::vector<size_t> bounds = Parallel::partition(*(this->rows), parts);
+        std::vector<std::vector<T> > partial(bounds.size() - 1);
+
+        const size_t * rowPtr = this->rows->data();
+        const size_t * colIdx = this->cols->data();
+        const T * values = this->vals->data();
+
+        Parallel::run(bounds, [&] (size_t part, size_t firstRow, size_t lastRow) {
+            std::vector<T> & sums = part == 0 ? result : partial[part];
+
+            if (part != 0) {
+                sums.assign(this->n, T());
+            }
+
+            for (size_t pos = rowPtr[firstRow]; pos < rowPtr[lastRow]; pos++) {
+                sums[colIdx[pos]] = sums[colIdx[pos]] + f(values[pos]);
+            }
+        });
+
+        for (size_t part = 1; part < partial.size(); part++) {
+            for (size_t j = 0; j < this->n; j++) {
+                result[j] = result[j] + partial[part][j];
+            }
+        }
+
+        return result;
+    }
+
+
+    // === FRIEND FUNCTIONS =========================================
 
     template<typename T>
     bool operator == (const SparseMatrix<T> & a, const SparseMatrix<T> & b)
     {
-        return ((a.vals == nullptr && b.vals == nullptr)
-                    || (a.vals != nullptr && b.vals != nullptr && *(a.vals) == *(b.vals)))
-                && ((a.cols == nullptr && b.cols == nullptr)
-                    || (a.cols != nullptr && b.cols != nullptr && *(a.cols) == *(b.cols)))
-                && *(a.rows) == *(b.rows);
+        if (*(a.rows) != *(b.rows)) {
+            return false;
+        }
+
+        if (a.getNnz() == 0) { // values may be unallocated or merely empty
+            return true;
+        }
+
+        return *(a.cols) == *(b.cols) && *(a.vals) == *(b.vals);
     }
 
 
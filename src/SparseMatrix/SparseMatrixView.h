@@ -0,0 +1,192 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_VIEW_H__
+
+	#define	__SPARSEMATRIX_VIEW_H__
+
+	#include <vector>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "semirings.h"
+
+
+	namespace Sparse
+	{
+
+		template<typename T>
+		class SparseMatrix;
+
+
+		/**
+		 * Read-only view of contiguous rows of a SparseMatrix.
+		 *
+		 * The view shares storage with the matrix it was created from, so it is
+		 * cheap to create and hand to another thread, but it is valid only while
+		 * that matrix exists and is not modified.
+		 */
+		template<typename T>
+		class SparseMatrixView
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				SparseMatrixView(size_t rows, size_t columns, const size_t * rowPointers, const size_t * columnIndices, const T * values, size_t firstRow);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+				size_t getFirstRow(void) const; // row of the parent matrix the view starts at
+
+
+				// === VALUES ==============================================
+
+				T get(size_t row, size_t col) const;
+				SparseMatrix<T> toMatrix(void) const; // standalone copy
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x) const;
+				std::vector<T> operator * (const std::vector<T> & x) const;
+
+				template<typename S>
+				std::vector<T> multiply(const std::vector<T> & x) const; // over semiring S
+
+
+			protected:
+
+				size_t m, n, firstRow;
+
+				// row pointers index the parent arrays directly
+				const size_t * rows, * cols;
+				const T * vals;
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    SparseMatrixView<T>::SparseMatrixView(size_t rows, size_t columns, const size_t * rowPointers, const size_t * columnIndices, const T * values, size_t firstRow)
+        : m(rows), n(columns), firstRow(firstRow), rows(rowPointers), cols(columnIndices), vals(values)
+    {}
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t SparseMatrixView<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t SparseMatrixView<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t SparseMatrixView<T>::getNnz(void) const
+    {
+        return this->rows[this->m] - this->rows[0];
+    }
+
+
+    template<typename T>
+    size_t SparseMatrixView<T>::getFirstRow(void) const
+    {
+        return this->firstRow;
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    T SparseMatrixView<T>::get(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+
+        const size_t * end = this->cols + this->rows[row + 1];
+        const size_t * pos = std::lower_bound(this->cols + this->rows[row], end, col);
+
+        return (pos != end && *pos == col) ? this->vals[pos - this->cols] : T();
+    }
+
+
+    template<typename T>
+    SparseMatrix<T> SparseMatrixView<T>::toMatrix(void) const
+    {
+        SparseMatrix<T> result(this->m, this->n);
+
+        size_t offset = this->rows[0];
+        std::vector<size_t> rows(this->m + 1);
+
+        for (size_t i = 0; i <= this->m; i++) {
+            rows[i] = this->rows[i] - offset;
+        }
+
+        std::vector<size_t> cols(this->cols + offset, this->cols + this->rows[this->m]);
+        std::vector<T> vals(this->vals + offset, this->vals + this->rows[this->m]);
+
+        result.assign(std::move(rows), std::move(cols), std::move(vals));
+        return result;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> SparseMatrixView<T>::multiply(const std::vector<T> & x) const
+    {
+        return this->template multiply<PlusTimes<T> >(x);
+    }
+
+
+    template<typename T>
+    std::vector<T> SparseMatrixView<T>::operator * (const std::vector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T>
+    template<typename S>
+    std::vector<T> SparseMatrixView<T>::multiply(const std::vector<T> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<T> result(this->m, S::zero());
+
+        for (size_t i = 0; i < this->m; i++) {
+            T sum = S::zero();
+            for (size_t j = this->rows[i]; j < this->rows[i + 1]; j++) {
+                sum = S::add(sum, S::multiply(this->vals[j], x[this->cols[j]]));
+            }
+
+            result[i] = sum;
+        }
+
+        return result;
+    }
+
+	}
+
+#endif
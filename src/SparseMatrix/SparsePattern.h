@@ -0,0 +1,378 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SPARSEPATTERN_H__
+
+	#define	__SPARSEMATRIX_SPARSEPATTERN_H__
+
+	#include <vector>
+	#include <iostream>
+	#include <algorithm>
+	#include "exceptions.h"
+
+
+	namespace Sparse
+	{
+
+		template<typename T>
+		class SparseMatrix;
+
+
+		/**
+		 * Structural (pattern-only) matrix - CRS format without the values array.
+		 * Behaves like a set of (row, column) coordinates.
+		 *
+		 * Held through std::shared_ptr<const SparsePattern> it is an immutable
+		 * structure several matrices can share, see SparseMatrix(pattern, values).
+		 */
+		class SparsePattern
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				SparsePattern(size_t n); // square pattern n×n
+				SparsePattern(size_t rows, size_t columns); // general pattern
+
+				template<typename T>
+				explicit SparsePattern(const SparseMatrix<T> & matrix); // pattern of non-zero elements
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+
+
+				// === VALUES ==============================================
+
+				bool contains(size_t row, size_t col) const;
+				bool insert(size_t row, size_t col); // returns false if already present
+				bool erase(size_t row, size_t col); // returns false if not present
+
+
+				// === OPERATIONS ==============================================
+
+				SparsePattern multiply(const SparsePattern & p) const; // boolean product
+				SparsePattern operator * (const SparsePattern & p) const;
+
+				SparsePattern unite(const SparsePattern & p) const;
+				SparsePattern operator | (const SparsePattern & p) const;
+
+				SparsePattern intersect(const SparsePattern & p) const;
+				SparsePattern operator & (const SparsePattern & p) const;
+
+
+				// === FRIEND FUNCTIONS =========================================
+
+				friend bool operator == (const SparsePattern & a, const SparsePattern & b);
+				friend bool operator != (const SparsePattern & a, const SparsePattern & b);
+				friend std::ostream & operator << (std::ostream & os, const SparsePattern & pattern);
+
+				template<typename X>
+				friend class SparseMatrix;
+
+
+			protected:
+
+				size_t m, n;
+
+				std::vector<size_t> rows, cols;
+
+
+				// === HELPERS / VALIDATORS ==============================================
+
+				void construct(size_t m, size_t n);
+				void validateCoordinates(size_t row, size_t col) const;
+				void validateDimensions(const SparsePattern & p, const char * message) const;
+				std::vector<size_t>::const_iterator find(size_t row, size_t col) const;
+
+				template<typename Merge>
+				SparsePattern merge(const SparsePattern & p, Merge keep) const;
+
+		};
+
+
+    // === CREATION ==============================================
+
+    inline SparsePattern::SparsePattern(size_t n)
+    {
+        this->construct(n, n);
+    }
+
+
+    inline SparsePattern::SparsePattern(size_t rows, size_t columns)
+    {
+        this->construct(rows, columns);
+    }
+
+
+    template<typename T>
+    SparsePattern::SparsePattern(const SparseMatrix<T> & matrix)
+    {
+        this->construct(matrix.m, matrix.n);
+
+        if (matrix.vals != nullptr) {
+            this->rows = *(matrix.rows);
+            this->cols = *(matrix.cols);
+        }
+    }
+
+
+    inline void SparsePattern::construct(size_t rows, size_t columns)
+    {
+        if (rows < 1 || columns < 1) {
+            throw InvalidDimensionsException("Matrix dimensions cannot be zero or negative.");
+        }
+
+        this->m = rows;
+        this->n = columns;
+        this->rows.assign(rows + 1, 0);
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    inline size_t SparsePattern::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    inline size_t SparsePattern::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    inline size_t SparsePattern::getNnz(void) const
+    {
+        return this->cols.size();
+    }
+
+
+    // === VALUES ==============================================
+
+    inline bool SparsePattern::contains(size_t row, size_t col) const
+    {
+        this->validateCoordinates(row, col);
+
+        std::vector<size_t>::const_iterator it = this->find(row, col);
+        return it != this->cols.begin() + this->rows[row + 1] && *it == col;
+    }
+
+
+    inline bool SparsePattern::insert(size_t row, size_t col)
+    {
+        this->validateCoordinates(row, col);
+
+        std::vector<size_t>::const_iterator it = this->find(row, col);
+
+        if (it != this->cols.begin() + this->rows[row + 1] && *it == col) {
+            return false;
+        }
+
+        this->cols.insert(it, col);
+
+        for (size_t i = row + 1; i <= this->m; i++) {
+            this->rows[i] += 1;
+        }
+
+        return true;
+    }
+
+
+    inline bool SparsePattern::erase(size_t row, size_t col)
+    {
+        this->validateCoordinates(row, col);
+
+        std::vector<size_t>::const_iterator it = this->find(row, col);
+
+        if (it == this->cols.begin() + this->rows[row + 1] || *it != col) {
+            return false;
+        }
+
+        this->cols.erase(it);
+
+        for (size_t i = row + 1; i <= this->m; i++) {
+            this->rows[i] -= 1;
+        }
+
+        return true;
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    inline SparsePattern SparsePattern::multiply(const SparsePattern & p) const
+    {
+        if (this->n != p.m) {
+            throw InvalidDimensionsException("Cannot multiply: Left matrix column count and right matrix row count don't match.");
+        }
+
+        SparsePattern result(this->m, p.n);
+
+        std::vector<size_t> marker(p.n, this->m);
+
+        for (size_t i = 0; i < this->m; i++) {
+            size_t rowStart = result.cols.size();
+
+            for (size_t a = this->rows[i]; a < this->rows[i + 1]; a++) {
+                size_t k = this->cols[a];
+
+                for (size_t b = p.rows[k]; b < p.rows[k + 1]; b++) {
+                    size_t j = p.cols[b];
+
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        result.cols.push_back(j);
+                    }
+                }
+            }
+
+            std::sort(result.cols.begin() + rowStart, result.cols.end());
+            result.rows[i + 1] = result.cols.size();
+        }
+
+        return result;
+    }
+
+
+    inline SparsePattern SparsePattern::operator * (const SparsePattern & p) const
+    {
+        return this->multiply(p);
+    }
+
+
+    inline SparsePattern SparsePattern::unite(const SparsePattern & p) const
+    {
+        this->validateDimensions(p, "Cannot unite: matrices dimensions don't match.");
+        return this->merge(p, [] (bool inLeft, bool inRight) { return inLeft || inRight; });
+    }
+
+
+    inline SparsePattern SparsePattern::operator | (const SparsePattern & p) const
+    {
+        return this->unite(p);
+    }
+
+
+    inline SparsePattern SparsePattern::intersect(const SparsePattern & p) const
+    {
+        this->validateDimensions(p, "Cannot intersect: matrices dimensions don't match.");
+        return this->merge(p, [] (bool inLeft, bool inRight) { return inLeft && inRight; });
+    }
+
+
+    inline SparsePattern SparsePattern::operator & (const SparsePattern & p) const
+    {
+        return this->intersect(p);
+    }
+
+
+    // === HELPERS / VALIDATORS ==============================================
+
+    inline void SparsePattern::validateCoordinates(size_t row, size_t col) const
+    {
+        if (row >= this->m || col >= this->n) {
+            throw InvalidCoordinatesException("Coordinates out of range.");
+        }
+    }
+
+
+    inline void SparsePattern::validateDimensions(const SparsePattern & p, const char * message) const
+    {
+        if (this->m != p.m || this->n != p.n) {
+            throw InvalidDimensionsException(message);
+        }
+    }
+
+
+    inline std::vector<size_t>::const_iterator SparsePattern::find(size_t row, size_t col) const
+    {
+        return std::lower_bound(this->cols.begin() + this->rows[row], this->cols.begin() + this->rows[row + 1], col);
+    }
+
+
+    template<typename Merge>
+    SparsePattern SparsePattern::merge(const SparsePattern & p, Merge keep) const
+    {
+        SparsePattern result(this->m, this->n);
+
+        for (size_t i = 0; i < this->m; i++) {
+            size_t a = this->rows[i], aEnd = this->rows[i + 1];
+            size_t b = p.rows[i], bEnd = p.rows[i + 1];
+
+            while (a < aEnd || b < bEnd) {
+                size_t left = a < aEnd ? this->cols[a] : this->n;
+                size_t right = b < bEnd ? p.cols[b] : this->n;
+                size_t col = std::min(left, right);
+
+                if (keep(left == col, right == col)) {
+                    result.cols.push_back(col);
+                }
+
+                a += left == col;
+                b += right == col;
+            }
+
+            result.rows[i + 1] = result.cols.size();
+        }
+
+        return result;
+    }
+
+
+    // === FRIEND FUNCTIONS =========================================
+
+    inline bool operator == (const SparsePattern & a, const SparsePattern & b)
+    {
+        return a.m == b.m && a.n == b.n && a.rows == b.rows && a.cols == b.cols;
+    }
+
+
+    inline bool operator != (const SparsePattern & a, const SparsePattern & b)
+    {
+        return !(a == b);
+    }
+
+
+    inline std::ostream & operator << (std::ostream & os, const SparsePattern & pattern)
+    {
+        for (size_t i = 0; i < pattern.m; i++) {
+            size_t pos = pattern.rows[i];
+
+            for (size_t j = 0; j < pattern.n; j++) {
+                if (j != 0) {
+                    os << " ";
+                }
+
+                if (pos < pattern.rows[i + 1] && pattern.cols[pos] == j) {
+                    os << "x";
+                    pos++;
+
+                } else {
+                    os << ".";
+                }
+            }
+
+            if (i < pattern.m - 1) {
+                os << std::endl;
+            }
+        }
+
+        return os;
+    }
+
+	}
+
+	#include "SparseMatrix.h"
+
+#endif
@@ -0,0 +1,354 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SPARSEVECTOR_H__
+
+	#define	__SPARSEMATRIX_SPARSEVECTOR_H__
+
+	#include <vector>
+	#include <cstdint>
+	#include <iostream>
+	#include <algorithm>
+	#include "exceptions.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Vector storing only its non-zero elements as sorted index and value arrays.
+		 *
+		 * "Zero" is the implicit value of missing elements - T() by default. Vectors
+		 * used with a semiring take its zero() instead (e.g. infinity for MinPlus),
+		 * so that T() is stored like any other value, such as a distance of 0.
+		 *
+		 * The optional bitmap (one bit per index) makes contains() O(1) - useful when
+		 * the vector is tested often, e.g. as a mask, at the price of size / 8 bytes.
+		 */
+		template<typename T>
+		class SparseVector
+		{
+
+			public:
+
+				// === CREATION ==============================================
+
+				explicit SparseVector(size_t size, const T & zero = T());
+				explicit SparseVector(const std::vector<T> & dense, const T & zero = T()); // zeros are skipped
+				SparseVector(size_t size, std::vector<size_t> indices, std::vector<T> values, const T & zero = T()); // indices have to be ascending
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getSize(void) const;
+				size_t getNnz(void) const;
+				const std::vector<size_t> & getIndices(void) const;
+				const std::vector<T> & getValues(void) const;
+				const T & getZero(void) const; // implicit value of missing elements
+
+
+				// === BITMAP ==============================================
+
+				SparseVector & enableBitmap(void);
+				SparseVector & disableBitmap(void);
+				bool hasBitmap(void) const;
+
+
+				// === VALUES ==============================================
+
+				bool contains(size_t index) const; // non-zero element stored at index
+				T get(size_t index) const;
+				SparseVector & set(T val, size_t index);
+				std::vector<T> toDense(void) const;
+
+
+				// === FRIEND FUNCTIONS =========================================
+
+				template<typename X>
+				friend bool operator == (const SparseVector<X> & a, const SparseVector<X> & b);
+
+				template<typename X>
+				friend std::ostream & operator << (std::ostream & os, const SparseVector<X> & vector);
+
+
+			protected:
+
+				size_t n;
+				T zero;
+				bool bitmapEnabled;
+
+				std::vector<size_t> indices;
+				std::vector<T> values;
+				std::vector<uint64_t> bitmap; // bit of every stored index if enabled
+
+
+				void validateIndex(size_t index) const;
+				void mark(size_t index, bool stored);
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    SparseVector<T>::SparseVector(size_t size, const T & zero)
+        : n(size), zero(zero), bitmapEnabled(false)
+    {}
+
+
+    template<typename T>
+    SparseVector<T>::SparseVector(const std::vector<T> & dense, const T & zero)
+        : n(dense.size()), zero(zero), bitmapEnabled(false)
+    {
+        for (size_t i = 0; i < this->n; i++) {
+            if (!(dense[i] == zero)) {
+                this->indices.push_back(i);
+                this->values.push_back(dense[i]);
+            }
+        }
+    }
+
+
+    template<typename T>
+    SparseVector<T>::SparseVector(size_t size, std::vector<size_t> indices, std::vector<T> values, const T & zero)
+        : n(size), zero(zero), bitmapEnabled(false)
+    {
+        if (indices.size() != values.size()) {
+            throw InvalidDimensionsException("Index count and value count don't match.");
+        }
+
+        for (size_t k = 0; k < indices.size(); k++) {
+            if (indices[k] >= size) {
+                throw InvalidCoordinatesException("Index out of range.");
+            }
+
+            if (k > 0 && indices[k] <= indices[k - 1]) {
+                throw InvalidArgumentException("Indices have to be strictly ascending.");
+            }
+        }
+
+        // zeros are not stored
+        size_t kept = 0;
+
+        for (size_t k = 0; k < indices.size(); k++) {
+            if (!(values[k] == zero)) {
+                indices[kept] = indices[k];
+                values[kept] = values[k];
+                kept++;
+            }
+        }
+
+        indices.resize(kept);
+        values.resize(kept);
+
+        this->indices = std::move(indices);
+        this->values = std::move(values);
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t SparseVector<T>::getSize(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t SparseVector<T>::getNnz(void) const
+    {
+        return this->indices.size();
+    }
+
+
+    template<typename T>
+    const std::vector<size_t> & SparseVector<T>::getIndices(void) const
+    {
+        return this->indices;
+    }
+
+
+    template<typename T>
+    const std::vector<T> & SparseVector<T>::getValues(void) const
+    {
+        return this->values;
+    }
+
+
+    template<typename T>
+    const T & SparseVector<T>::getZero(void) const
+    {
+        return this->zero;
+    }
+
+
+    // === BITMAP ==============================================
+
+    template<typename T>
+    SparseVector<T> & SparseVector<T>::enableBitmap(void)
+    {
+        if (!this->bitmapEnabled) {
+            this->bitmapEnabled = true;
+            this->bitmap.assign((this->n + 63) / 64, 0);
+
+            for (size_t index : this->indices) {
+                this->mark(index, true);
+            }
+        }
+
+        return *this;
+    }
+
+
+    template<typename T>
+    SparseVector<T> & SparseVector<T>::disableBitmap(void)
+    {
+        this->bitmapEnabled = false;
+        std::vector<uint64_t>().swap(this->bitmap);
+
+        return *this;
+    }
+
+
+    template<typename T>
+    bool SparseVector<T>::hasBitmap(void) const
+    {
+        return this->bitmapEnabled;
+    }
+
+
+    // === VALUES ==============================================
+
+    template<typename T>
+    bool SparseVector<T>::contains(size_t index) const
+    {
+        this->validateIndex(index);
+
+        if (this->bitmapEnabled) {
+            return (this->bitmap[index >> 6] >> (index & 63)) & 1;
+        }
+
+        return std::binary_search(this->indices.begin(), this->indices.end(), index);
+    }
+
+
+    template<typename T>
+    T SparseVector<T>::get(size_t index) const
+    {
+        this->validateIndex(index);
+
+        if (this->bitmapEnabled && !((this->bitmap[index >> 6] >> (index & 63)) & 1)) {
+            return this->zero;
+        }
+
+        std::vector<size_t>::const_iterator it = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+
+        if (it == this->indices.end() || *it != index) {
+            return this->zero;
+        }
+
+        return this->values[it - this->indices.begin()];
+    }
+
+
+    template<typename T>
+    SparseVector<T> & SparseVector<T>::set(T val, size_t index)
+    {
+        this->validateIndex(index);
+
+        std::vector<size_t>::iterator it = std::lower_bound(this->indices.begin(), this->indices.end(), index);
+        size_t pos = it - this->indices.begin();
+        bool stored = it != this->indices.end() && *it == index;
+
+        if (val == this->zero) {
+            if (stored) {
+                this->indices.erase(it);
+                this->values.erase(this->values.begin() + pos);
+                this->mark(index, false);
+            }
+
+        } else if (stored) {
+            this->values[pos] = val;
+
+        } else {
+            this->indices.insert(it, index);
+            this->values.insert(this->values.begin() + pos, val);
+            this->mark(index, true);
+        }
+
+        return *this;
+    }
+
+
+    template<typename T>
+    std::vector<T> SparseVector<T>::toDense(void) const
+    {
+        std::vector<T> result(this->n, this->zero);
+
+        for (size_t k = 0; k < this->indices.size(); k++) {
+            result[this->indices[k]] = this->values[k];
+        }
+
+        return result;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void SparseVector<T>::validateIndex(size_t index) const
+    {
+        if (index >= this->n) {
+            throw InvalidCoordinatesException("Index out of range.");
+        }
+    }
+
+
+    template<typename T>
+    void SparseVector<T>::mark(size_t index, bool stored)
+    {
+        if (!this->bitmapEnabled) {
+            return ;
+        }
+
+        uint64_t bit = static_cast<uint64_t>(1) << (index & 63);
+
+        if (stored) {
+            this->bitmap[index >> 6] |= bit;
+
+        } else {
+            this->bitmap[index >> 6] &= ~bit;
+        }
+    }
+
+
+    // === FRIEND FUNCTIONS =========================================
+
+    template<typename T>
+    bool operator == (const SparseVector<T> & a, const SparseVector<T> & b)
+    {
+        return a.n == b.n && a.zero == b.zero && a.indices == b.indices && a.values == b.values;
+    }
+
+
+    template<typename T>
+    std::ostream & operator << (std::ostream & os, const SparseVector<T> & vector)
+    {
+        os << "[" << vector.n << "]";
+
+        for (size_t k = 0; k < vector.indices.size(); k++) {
+            os << " " << vector.indices[k] << ":" << vector.values[k];
+        }
+
+        return os;
+    }
+
+	}
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_TILEDSPARSEMATRIX_H__
+
+	#define	__SPARSEMATRIX_TILEDSPARSEMATRIX_H__
+
+	#include <vector>
+	#include <cstdint>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Read-only copy of a SparseMatrix split into column tiles.
+		 *
+		 * Every tile holds its own CRS structure (non-empty rows only) with column
+		 * indices relative to the tile. Vector multiplication processes one tile
+		 * at a time, so only the matching slice of x has to stay in cache. This
+		 * pays off for very wide matrices where x does not fit into L2 cache.
+		 */
+		template<typename T>
+		class TiledSparseMatrix
+		{
+
+			public:
+
+				// default tile covers this many bytes of the multiplied vector
+				static const size_t DEFAULT_TILE_BYTES = 256 * 1024;
+
+
+				// === CREATION ==============================================
+
+				explicit TiledSparseMatrix(const SparseMatrix<T> & matrix, size_t tileWidth = DEFAULT_TILE_BYTES / sizeof(T));
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getColumnCount(void) const;
+				size_t getNnz(void) const;
+				size_t getTileWidth(void) const;
+				size_t getTileCount(void) const;
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> multiply(const std::vector<T> & x) const;
+				std::vector<T> operator * (const std::vector<T> & x) const;
+
+				template<typename S>
+				std::vector<T> multiply(const std::vector<T> & x) const; // over semiring S
+
+
+			protected:
+
+				struct Tile
+				{
+					std::vector<size_t> rowIndices; // non-empty rows of the tile
+					std::vector<size_t> rows; // pointers into cols/vals for every non-empty row
+					std::vector<uint32_t> cols; // relative to the first column of the tile
+					std::vector<T> vals;
+				};
+
+
+				size_t m, n, nnz, tileWidth;
+
+				std::vector<Tile> tiles;
+				std::vector<size_t> rowWork; // prefix sums of row lengths, used to split rows between threads
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    TiledSparseMatrix<T>::TiledSparseMatrix(const SparseMatrix<T> & matrix, size_t tileWidth)
+    {
+        if (tileWidth < 1 || tileWidth > UINT32_MAX) {
+            throw InvalidArgumentException("Tile width has to be between 1 and 2^32 - 1.");
+        }
+
+        this->m = matrix.m;
+        this->n = matrix.n;
+        this->nnz = matrix.getNnz();
+        this->tileWidth = tileWidth;
+        this->tiles.resize((this->n + tileWidth - 1) / tileWidth);
+        this->rowWork = *(matrix.rows);
+
+        for (size_t t = 0; t < this->tiles.size(); t++) {
+            this->tiles[t].rows.push_back(0);
+        }
+
+        // columns in a row are sorted, so the row is cut into consecutive tile segments
+        for (size_t i = 0; i < this->m; i++) {
+            for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                size_t col = (*(matrix.cols))[pos];
+                Tile & tile = this->tiles[col / tileWidth];
+
+                if (tile.rowIndices.empty() || tile.rowIndices.back() != i) {
+                    tile.rowIndices.push_back(i);
+                    tile.rows.push_back(tile.rows.back());
+                }
+
+                tile.cols.push_back(static_cast<uint32_t>(col % tileWidth));
+                tile.vals.push_back((*(matrix.vals))[pos]);
+                tile.rows.back()++;
+            }
+        }
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t TiledSparseMatrix<T>::getRowCount(void) const
+    {
+        return this->m;
+    }
+
+
+    template<typename T>
+    size_t TiledSparseMatrix<T>::getColumnCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t TiledSparseMatrix<T>::getNnz(void) const
+    {
+        return this->nnz;
+    }
+
+
+    template<typename T>
+    size_t TiledSparseMatrix<T>::getTileWidth(void) const
+    {
+        return this->tileWidth;
+    }
+
+
+    template<typename T>
+    size_t TiledSparseMatrix<T>::getTileCount(void) const
+    {
+        return this->tiles.size();
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> TiledSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        return this->template multiply<PlusTimes<T> >(x);
+    }
+
+
+    template<typename T>
+    std::vector<T> TiledSparseMatrix<T>::operator * (const std::vector<T> & x) const
+    {
+        return this->multiply(x);
+    }
+
+
+    template<typename T>
+    template<typename S>
+    std::vector<T> TiledSparseMatrix<T>::multiply(const std::vector<T> & x) const
+    {
+        if (this->n != x.size()) {
+            throw InvalidDimensionsException("Cannot multiply: Matrix column count and vector size don't match.");
+        }
+
+        std::vector<T> result(this->m, S::zero());
+
+        // every chunk of rows walks all tiles
+
+        Parallel::parallelFor(this->rowWork, [&] (size_t firstRow, size_t lastRow) {
+            for (size_t t = 0; t < this->tiles.size(); t++) {
+                const Tile & tile = this->tiles[t];
+                const T * slice = x.data() + t * this->tileWidth;
+
+                size_t r = std::lower_bound(tile.rowIndices.begin(), tile.rowIndices.end(), firstRow) - tile.rowIndices.begin();
+
+                for (; r < tile.rowIndices.size() && tile.rowIndices[r] < lastRow; r++) {
+                    T sum = S::zero();
+                    for (size_t pos = tile.rows[r]; pos < tile.rows[r + 1]; pos++) {
+                        sum = S::add(sum, S::multiply(tile.vals[pos], slice[tile.cols[pos]]));
+                    }
+
+                    result[tile.rowIndices[r]] = S::add(result[tile.rowIndices[r]], sum);
+                }
+            }
+        });
+
+        return result;
+    }
+
+	}
+
+#endif
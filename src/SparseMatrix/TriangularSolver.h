@@ -0,0 +1,291 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_TRIANGULARSOLVER_H__
+
+	#define	__SPARSEMATRIX_TRIANGULARSOLVER_H__
+
+	#include <vector>
+	#include <numeric>
+	#include <algorithm>
+	#include "exceptions.h"
+	#include "parallel.h"
+	#include "SparseMatrix.h"
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Forward / backward substitution with a lower or upper triangle of a square matrix.
+		 *
+		 * Elements outside the chosen triangle are ignored, so L and U factors stored
+		 * in one matrix can be used directly. The constructor splits rows into levels -
+		 * rows of one level depend only on rows of previous levels - and solve() runs
+		 * rows of each wide level in parallel. The analysis depends on the pattern only,
+		 * update() replaces values without repeating it.
+		 */
+		template<typename T>
+		class TriangularSolver
+		{
+
+			public:
+
+				enum Triangle
+				{
+					LOWER,
+					UPPER
+				};
+
+
+				enum Diagonal
+				{
+					EXPLICIT, // diagonal elements are stored in the matrix
+					UNIT // diagonal is all ones, stored diagonal elements are ignored
+				};
+
+
+				// === CREATION ==============================================
+
+				TriangularSolver(const SparseMatrix<T> & matrix, Triangle triangle, Diagonal diagonal = EXPLICIT);
+
+
+				// === GETTERS / SETTERS ==============================================
+
+				size_t getRowCount(void) const;
+				size_t getLevelCount(void) const;
+
+				void update(const SparseMatrix<T> & matrix); // same pattern, new values
+
+
+				// === OPERATIONS ==============================================
+
+				std::vector<T> solve(const std::vector<T> & b) const; // x such that triangle * x = b
+
+
+			protected:
+
+				// narrower levels are solved by the calling thread alone
+				static const size_t MINIMUM_LEVEL_ROWS = 32;
+
+
+				size_t n;
+				Triangle triangle;
+				Diagonal diagonal;
+
+				// strict triangle in CRS format, diagonal kept aside
+				std::vector<size_t> rows, cols;
+				std::vector<T> vals, diag;
+
+				// rows of level l are levelRows[levels[l]] ... levelRows[levels[l + 1] - 1]
+				std::vector<size_t> levels, levelRows;
+
+
+				void extract(const SparseMatrix<T> & matrix, std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals, std::vector<T> & diag) const;
+				void analyze(void);
+				void solveRow(size_t row, const std::vector<T> & b, std::vector<T> & x) const;
+
+		};
+
+
+    // === CREATION ==============================================
+
+    template<typename T>
+    TriangularSolver<T>::TriangularSolver(const SparseMatrix<T> & matrix, Triangle triangle, Diagonal diagonal)
+        : n(matrix.getRowCount()), triangle(triangle), diagonal(diagonal)
+    {
+        if (matrix.getRowCount() != matrix.getColumnCount()) {
+            throw InvalidDimensionsException("Cannot solve: Matrix has to be square.");
+        }
+
+        this->extract(matrix, this->rows, this->cols, this->vals, this->diag);
+        this->analyze();
+    }
+
+
+    // === GETTERS / SETTERS ==============================================
+
+    template<typename T>
+    size_t TriangularSolver<T>::getRowCount(void) const
+    {
+        return this->n;
+    }
+
+
+    template<typename T>
+    size_t TriangularSolver<T>::getLevelCount(void) const
+    {
+        return this->levels.size() - 1;
+    }
+
+
+    template<typename T>
+    void TriangularSolver<T>::update(const SparseMatrix<T> & matrix)
+    {
+        if (matrix.getRowCount() != this->n || matrix.getColumnCount() != this->n) {
+            throw InvalidDimensionsException("Cannot update: Matrix dimensions don't match.");
+        }
+
+        std::vector<size_t> rows, cols;
+        std::vector<T> vals, diag;
+
+        this->extract(matrix, rows, cols, vals, diag);
+
+        if (rows != this->rows || cols != this->cols) {
+            throw InvalidArgumentException("Cannot update: Matrix pattern doesn't match the analysed one.");
+        }
+
+        this->vals.swap(vals);
+        this->diag.swap(diag);
+    }
+
+
+    // === OPERATIONS ==============================================
+
+    template<typename T>
+    std::vector<T> TriangularSolver<T>::solve(const std::vector<T> & b) const
+    {
+        if (b.size() != this->n) {
+            throw InvalidDimensionsException("Cannot solve: Matrix row count and vector size don't match.");
+        }
+
+        std::vector<T> x(this->n);
+
+        size_t levelCount = this->getLevelCount();
+        size_t threads = Parallel::getThreadCount();
+
+        // every parallel level costs a round trip through the pool, so it has to be wide enough
+        if (threads < 2 || this->cols.size() + this->n < Parallel::MINIMUM_WORK || this->n / levelCount < threads) {
+            for (size_t k = 0; k < this->n; k++) {
+                this->solveRow(this->triangle == LOWER ? k : this->n - 1 - k, b, x);
+            }
+
+            return x;
+        }
+
+        std::vector<size_t> bounds(threads + 1);
+
+        for (size_t l = 0; l < levelCount; l++) {
+            size_t first = this->levels[l], count = this->levels[l + 1] - first;
+
+            if (count < threads * MINIMUM_LEVEL_ROWS) {
+                for (size_t k = first; k < first + count; k++) {
+                    this->solveRow(this->levelRows[k], b, x);
+                }
+
+                continue;
+            }
+
+            for (size_t t = 0; t <= threads; t++) {
+                bounds[t] = first + count * t / threads;
+            }
+
+            Parallel::run(bounds, [&] (size_t, size_t begin, size_t end) {
+                for (size_t k = begin; k < end; k++) {
+                    this->solveRow(this->levelRows[k], b, x);
+                }
+            });
+        }
+
+        return x;
+    }
+
+
+    // === HELPERS ==============================================
+
+    template<typename T>
+    void TriangularSolver<T>::extract(const SparseMatrix<T> & matrix, std::vector<size_t> & rows, std::vector<size_t> & cols, std::vector<T> & vals, std::vector<T> & diag) const
+    {
+        size_t nnz = matrix.getNnz();
+
+        rows.assign(this->n + 1, 0);
+        cols.clear();
+        vals.clear();
+        diag.assign(this->n, T(1));
+
+        cols.reserve(nnz);
+        vals.reserve(nnz);
+
+        for (size_t i = 0; i < this->n; i++) {
+            bool hasDiagonal = false;
+
+            for (size_t pos = (*(matrix.rows))[i]; pos < (*(matrix.rows))[i + 1]; pos++) {
+                size_t col = (*(matrix.cols))[pos];
+
+                if (col == i) {
+                    hasDiagonal = !((*(matrix.vals))[pos] == T());
+
+                    if (this->diagonal == EXPLICIT) {
+                        diag[i] = (*(matrix.vals))[pos];
+                    }
+
+                } else if ((this->triangle == LOWER) == (col < i)) {
+                    cols.push_back(col);
+                    vals.push_back((*(matrix.vals))[pos]);
+                }
+            }
+
+            if (this->diagonal == EXPLICIT && !hasDiagonal) {
+                throw InvalidArgumentException("Cannot solve: Zero on the diagonal.");
+            }
+
+            rows[i + 1] = cols.size();
+        }
+    }
+
+
+    template<typename T>
+    void TriangularSolver<T>::analyze(void)
+    {
+        // level of a row is one more than the deepest row it depends on
+        std::vector<size_t> level(this->n, 0);
+        size_t levelCount = 1;
+
+        for (size_t k = 0; k < this->n; k++) {
+            size_t i = this->triangle == LOWER ? k : this->n - 1 - k;
+
+            for (size_t pos = this->rows[i]; pos < this->rows[i + 1]; pos++) {
+                level[i] = std::max(level[i], level[this->cols[pos]] + 1);
+            }
+
+            levelCount = std::max(levelCount, level[i] + 1);
+        }
+
+        // counting sort of rows by level
+        this->levels.assign(levelCount + 1, 0);
+
+        for (size_t i = 0; i < this->n; i++) {
+            this->levels[level[i] + 1]++;
+        }
+
+        std::partial_sum(this->levels.begin(), this->levels.end(), this->levels.begin());
+
+        this->levelRows.resize(this->n);
+        std::vector<size_t> next(this->levels.begin(), this->levels.end() - 1);
+
+        for (size_t i = 0; i < this->n; i++) {
+            this->levelRows[next[level[i]]++] = i;
+        }
+    }
+
+
+    template<typename T>
+    void TriangularSolver<T>::solveRow(size_t row, const std::vector<T> & b, std::vector<T> & x) const
+    {
+        T sum = b[row];
+
+        for (size_t pos = this->rows[row]; pos < this->rows[row + 1]; pos++) {
+            sum = sum - this->vals[pos] * x[this->cols[pos]];
+        }
+
+        x[row] = this->diagonal == UNIT ? sum : sum / this->diag[row];
+    }
+
+	}
+
+#endif
@@ -0,0 +1,180 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_ACCUMULATOR_H__
+
+	#define	__SPARSEMATRIX_ACCUMULATOR_H__
+
+	#include <vector>
+	#include <algorithm>
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Sparse accumulator collecting one output row of a product.
+		 *
+		 * Dense variant indexes arrays of the full row width, hash variant
+		 * (open addressing) is used for very wide rows where per-thread dense
+		 * arrays would not fit into cache.
+		 *
+		 * @internal
+		 */
+		template<typename T, typename S>
+		class SparseAccumulator
+		{
+
+			public:
+
+				// rows narrower than this always use the dense variant
+				static const size_t DENSE_LIMIT = 1 << 16;
+
+
+				/**
+				 * @param columns    width of the accumulated rows
+				 * @param maxEntries upper bound of entries accumulated into one row
+				 * @param denseLimit rows narrower than this use the dense variant, 0 when the accumulator is used only once
+				 */
+				SparseAccumulator(size_t columns, size_t maxEntries, size_t denseLimit = DENSE_LIMIT)
+				{
+					this->dense = columns <= denseLimit || columns <= 8 * maxEntries;
+
+					if (this->dense) {
+						this->generation = 1;
+						this->marker.assign(columns, 0);
+						this->values.assign(columns, S::zero());
+
+					} else {
+						size_t bits = 4;
+						while ((static_cast<size_t>(1) << bits) < 2 * maxEntries) {
+							bits++;
+						}
+
+						this->shift = sizeof(size_t) * 8 - bits;
+						this->mask = (static_cast<size_t>(1) << bits) - 1;
+						this->marker.assign(this->mask + 1, EMPTY);
+						this->values.assign(this->mask + 1, S::zero());
+					}
+				}
+
+
+				void clear(void)
+				{
+					if (this->dense) {
+						this->generation++;
+
+					} else {
+						for (size_t slot : this->touched) {
+							this->marker[slot] = EMPTY;
+						}
+					}
+
+					this->touched.clear();
+				}
+
+
+				/** Registers column without value (symbolic phase) */
+				void mark(size_t col)
+				{
+					this->find(col);
+				}
+
+
+				void accumulate(size_t col, const T & val)
+				{
+					size_t slot = this->find(col);
+					this->values[slot] = S::add(this->values[slot], val);
+				}
+
+
+				/** @return Number of distinct columns accumulated since clear() */
+				size_t size(void) const
+				{
+					return this->touched.size();
+				}
+
+
+				/**
+				 * Writes accumulated row sorted by columns, elements equal to S::zero() are skipped
+				 *
+				 * @return Number of elements written
+				 */
+				size_t gather(size_t * cols, T * vals)
+				{
+					if (this->dense) {
+						std::sort(this->touched.begin(), this->touched.end());
+
+					} else {
+						const std::vector<size_t> & keys = this->marker;
+						std::sort(this->touched.begin(), this->touched.end(), [&keys] (size_t a, size_t b) {
+							return keys[a] < keys[b];
+						});
+					}
+
+					size_t count = 0;
+
+					for (size_t slot : this->touched) {
+						if (!(this->values[slot] == S::zero())) {
+							cols[count] = this->dense ? slot : this->marker[slot];
+							vals[count] = this->values[slot];
+							count++;
+						}
+					}
+
+					return count;
+				}
+
+
+			protected:
+
+				enum : size_t { EMPTY = static_cast<size_t>(-1) };
+
+				bool dense;
+				size_t generation, shift, mask;
+
+				std::vector<size_t> marker; // dense: generation of each column, hash: column of each slot
+				std::vector<T> values;
+				std::vector<size_t> touched; // dense: columns, hash: slots
+
+
+				/** @return Slot of the column, new slots start at S::zero() */
+				size_t find(size_t col)
+				{
+					if (this->dense) {
+						if (this->marker[col] != this->generation) {
+							this->marker[col] = this->generation;
+							this->values[col] = S::zero();
+							this->touched.push_back(col);
+						}
+
+						return col;
+					}
+
+					// Fibonacci hashing - take the top bits of the product
+					size_t slot = (col * static_cast<size_t>(0x9E3779B97F4A7C15ull)) >> this->shift;
+
+					while (this->marker[slot] != col) {
+						if (this->marker[slot] == EMPTY) {
+							this->marker[slot] = col;
+							this->values[slot] = S::zero();
+							this->touched.push_back(slot);
+							break;
+						}
+
+						slot = (slot + 1) & this->mask;
+					}
+
+					return slot;
+				}
+
+		};
+
+	}
+
+#endif
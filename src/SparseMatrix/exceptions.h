@@ -63,6 +63,28 @@
 
 		};
 
+
+		class InvalidArgumentException : public Exception
+		{
+
+			public:
+
+				InvalidArgumentException(const std::string & message) : Exception(message)
+				{}
+
+		};
+
+
+		class SystemException : public Exception // failure of the operating system (shared memory, processes)
+		{
+
+			public:
+
+				SystemException(const std::string & message) : Exception(message)
+				{}
+
+		};
+
 	}
 
 #endif
@@ -0,0 +1,403 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_PARALLEL_H__
+
+	#define	__SPARSEMATRIX_PARALLEL_H__
+
+	#include <mutex>
+	#include <deque>
+	#include <atomic>
+	#include <memory>
+	#include <thread>
+	#include <vector>
+	#include <algorithm>
+	#include <exception>
+	#include <functional>
+	#include <condition_variable>
+
+	#if defined(__linux__)
+		#include <pthread.h>
+	#endif
+
+
+	namespace Sparse
+	{
+
+		namespace Parallel
+		{
+
+			// kernels with less estimated work than this run on the calling thread
+			const size_t MINIMUM_WORK = 1 << 15;
+
+			// parallelFor() splits work into chunks of at least this size, several per thread
+			const size_t GRAIN_WORK = 1 << 13;
+			const size_t CHUNKS_PER_THREAD = 4;
+
+
+			inline std::atomic<size_t> & threadCountSetting(void)
+			{
+				static std::atomic<size_t> count(0);
+				return count;
+			}
+
+
+			/** @return Number of threads used by parallel kernels */
+			inline size_t getThreadCount(void)
+			{
+				size_t count = threadCountSetting().load(std::memory_order_relaxed);
+
+				if (count == 0) {
+					count = std::thread::hardware_concurrency();
+				}
+
+				return std::max<size_t>(count, 1);
+			}
+
+
+			/** @param count Number of threads, 0 means number of hardware threads */
+			inline void setThreadCount(size_t count)
+			{
+				threadCountSetting().store(count, std::memory_order_relaxed);
+			}
+
+
+			/**
+			 * Splits items into contiguous ranges of roughly equal work
+			 *
+			 * @param  work  prefix sums of work per item (size is item count + 1)
+			 * @param  parts maximum number of ranges
+			 * @return range bounds - part p covers items [bounds[p], bounds[p + 1])
+			 */
+			inline std::vector<size_t> partition(const std::vector<size_t> & work, size_t parts)
+			{
+				size_t count = work.size() - 1;
+				size_t total = work.back() - work.front();
+
+				parts = std::max<size_t>(std::min(parts, count), 1);
+
+				std::vector<size_t> bounds(1, 0);
+
+				for (size_t p = 1; p < parts; p++) {
+					size_t target = work.front() + total / parts * p;
+					size_t bound = std::lower_bound(work.begin(), work.end(), target) - work.begin();
+
+					if (bound > bounds.back() && bound < count) {
+						bounds.push_back(bound);
+					}
+				}
+
+				bounds.push_back(count);
+				return bounds;
+			}
+
+
+			/**
+			 * Work-stealing pool shared by all parallel kernels.
+			 *
+			 * Every worker owns a deque - it takes its own tasks from the back and steals
+			 * from the front of the others when idle. Tasks submitted from outside the
+			 * pool go to an extra shared deque. Threads waiting for their tasks keep
+			 * executing pending ones, so nested parallel calls reuse the same workers
+			 * instead of starting new threads.
+			 */
+			class ThreadPool
+			{
+
+				public:
+
+					ThreadPool(size_t workers, const std::vector<size_t> & cpus) : stopping(false), pending(0)
+					{
+						for (size_t w = 0; w <= workers; w++) {
+							this->queues.push_back(std::unique_ptr<Queue>(new Queue()));
+						}
+
+						for (size_t w = 0; w < workers; w++) {
+							this->threads.push_back(std::thread([this, w] () { this->work(w); }));
+
+							#if defined(__linux__)
+								if (!cpus.empty()) {
+									cpu_set_t set;
+									CPU_ZERO(&set);
+									CPU_SET(cpus[w % cpus.size()], &set);
+									pthread_setaffinity_np(this->threads.back().native_handle(), sizeof(cpu_set_t), &set);
+								}
+							#endif
+						}
+					}
+
+
+					~ThreadPool(void)
+					{
+						{
+							std::lock_guard<std::mutex> lock(this->mutex);
+							this->stopping = true;
+						}
+
+						this->condition.notify_all();
+
+						for (size_t t = 0; t < this->threads.size(); t++) {
+							this->threads[t].join();
+						}
+					}
+
+
+					size_t getWorkerCount(void) const
+					{
+						return this->threads.size();
+					}
+
+
+					/** @return Pool the calling thread works for, nullptr outside of any pool */
+					static ThreadPool *& current(void)
+					{
+						static thread_local ThreadPool * pool = nullptr;
+						return pool;
+					}
+
+
+					void submit(std::function<void(void)> task)
+					{
+						Queue & queue = *(this->queues[current() == this ? currentWorker() : this->threads.size()]);
+
+						{
+							std::lock_guard<std::mutex> lock(this->mutex);
+							this->pending++;
+						}
+
+						{
+							std::lock_guard<std::mutex> lock(queue.mutex);
+							queue.tasks.push_back(std::move(task));
+						}
+
+						this->condition.notify_one();
+					}
+
+
+					/** Runs one pending task - own deque first, then stolen ones. @return false if there was none */
+					bool runPending(void)
+					{
+						std::function<void(void)> task;
+						size_t own = current() == this ? currentWorker() : this->threads.size();
+
+						for (size_t k = 0; k < this->queues.size() && !task; k++) {
+							Queue & queue = *(this->queues[(own + k) % this->queues.size()]);
+							std::lock_guard<std::mutex> lock(queue.mutex);
+
+							if (!queue.tasks.empty()) {
+								if (k == 0) {
+									task = std::move(queue.tasks.back());
+									queue.tasks.pop_back();
+
+								} else {
+									task = std::move(queue.tasks.front());
+									queue.tasks.pop_front();
+								}
+							}
+						}
+
+						if (!task) {
+							return false;
+						}
+
+						{
+							std::lock_guard<std::mutex> lock(this->mutex);
+							this->pending--;
+						}
+
+						task();
+						return true;
+					}
+
+
+				protected:
+
+					struct Queue
+					{
+						std::mutex mutex;
+						std::deque<std::function<void(void)> > tasks;
+					};
+
+
+					std::vector<std::unique_ptr<Queue> > queues; // one per worker, the last one for outside threads
+					std::vector<std::thread> threads;
+
+					std::mutex mutex;
+					std::condition_variable condition;
+					bool stopping;
+					size_t pending;
+
+
+					static size_t & currentWorker(void)
+					{
+						static thread_local size_t worker = 0;
+						return worker;
+					}
+
+
+					void work(size_t worker)
+					{
+						current() = this;
+						currentWorker() = worker;
+
+						while (true) {
+							{
+								std::unique_lock<std::mutex> lock(this->mutex);
+								this->condition.wait(lock, [this] () { return this->stopping || this->pending > 0; });
+
+								if (this->stopping) {
+									return ;
+								}
+							}
+
+							this->runPending();
+						}
+					}
+
+			};
+
+
+			inline std::mutex & poolMutex(void)
+			{
+				static std::mutex mutex;
+				return mutex;
+			}
+
+
+			inline std::vector<size_t> & affinitySetting(void)
+			{
+				static std::vector<size_t> cpus;
+				return cpus;
+			}
+
+
+			inline std::unique_ptr<ThreadPool> & poolInstance(void)
+			{
+				static std::unique_ptr<ThreadPool> pool;
+				return pool;
+			}
+
+
+			/**
+			 * @return Shared pool with getThreadCount() - 1 workers (the calling thread is the last one).
+			 * The pool is recreated after the thread count or affinity changes, so the settings
+			 * must not change while parallel kernels run.
+			 */
+			inline ThreadPool & pool(void)
+			{
+				if (ThreadPool::current() != nullptr) { // nested call from a worker
+					return *ThreadPool::current();
+				}
+
+				std::lock_guard<std::mutex> lock(poolMutex());
+				std::unique_ptr<ThreadPool> & pool = poolInstance();
+
+				if (!pool || pool->getWorkerCount() != getThreadCount() - 1) {
+					pool.reset();
+					pool.reset(new ThreadPool(getThreadCount() - 1, affinitySetting()));
+				}
+
+				return *pool;
+			}
+
+
+			/** @param cpus CPUs the workers are pinned to in round robin, empty means no pinning (Linux only) */
+			inline void setAffinity(const std::vector<size_t> & cpus)
+			{
+				std::lock_guard<std::mutex> lock(poolMutex());
+
+				affinitySetting() = cpus;
+				poolInstance().reset();
+			}
+
+
+			/**
+			 * Runs task(part, begin, end) for every range on the shared pool and waits for all of them.
+			 * The first range runs on the calling thread. Exception thrown by any task is rethrown.
+			 * Parts may run one after another, so they must not wait for each other.
+			 */
+			template<typename Task>
+			void run(const std::vector<size_t> & bounds, Task task)
+			{
+				size_t parts = bounds.size() - 1;
+
+				if (parts == 1) {
+					task(0, bounds[0], bounds[1]);
+					return ;
+				}
+
+				ThreadPool & workers = pool();
+				std::vector<std::exception_ptr> errors(parts);
+				std::atomic<size_t> remaining(parts - 1);
+
+				for (size_t p = 1; p < parts; p++) {
+					workers.submit([&, p] () {
+						try {
+							task(p, bounds[p], bounds[p + 1]);
+
+						} catch (...) {
+							errors[p] = std::current_exception();
+						}
+
+						remaining.fetch_sub(1, std::memory_order_acq_rel);
+					});
+				}
+
+				try {
+					task(0, bounds[0], bounds[1]);
+
+				} catch (...) {
+					errors[0] = std::current_exception();
+				}
+
+				// help with pending tasks (possibly of other callers) until all parts are done
+				while (remaining.load(std::memory_order_acquire) > 0) {
+					if (!workers.runPending()) {
+						std::this_thread::yield();
+					}
+				}
+
+				for (size_t p = 0; p < parts; p++) {
+					if (errors[p]) {
+						std::rethrow_exception(errors[p]);
+					}
+				}
+			}
+
+
+			/**
+			 * Runs task(begin, end) over items [0, work.size() - 1) split by work
+			 *
+			 * Chunks hold at least GRAIN_WORK units and there are several of them per thread,
+			 * so threads which finish early take over the rest of a skewed split.
+			 *
+			 * @param work prefix sums of work per item, e.g. row pointers for nnz-weighted rows
+			 */
+			template<typename Task>
+			void parallelFor(const std::vector<size_t> & work, Task task)
+			{
+				size_t total = work.back() - work.front();
+				size_t threads = getThreadCount();
+
+				if (threads < 2 || total < MINIMUM_WORK) {
+					task(static_cast<size_t>(0), work.size() - 1);
+					return ;
+				}
+
+				size_t chunks = std::min(threads * CHUNKS_PER_THREAD, total / GRAIN_WORK);
+
+				run(partition(work, chunks), [&task] (size_t, size_t begin, size_t end) {
+					task(begin, end);
+				});
+			}
+
+		}
+
+	}
+
+#endif
@@ -0,0 +1,182 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_PRECISION_H__
+
+	#define	__SPARSEMATRIX_PRECISION_H__
+
+	#include <cmath>
+	#include <cstdint>
+	#include <cstring>
+	#include <algorithm>
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * IEEE 754 half precision (binary16) emulated in software.
+		 * Used only as a storage type - arithmetic goes through float.
+		 */
+		struct Half
+		{
+			uint16_t bits;
+
+			Half(void) : bits(0)
+			{}
+
+			explicit Half(float value);
+			operator float(void) const;
+		};
+
+
+		/** Upper half of IEEE 754 single precision, keeps float range with 8-bit mantissa */
+		struct BFloat16
+		{
+			uint16_t bits;
+
+			BFloat16(void) : bits(0)
+			{}
+
+			explicit BFloat16(float value);
+			operator float(void) const;
+		};
+
+
+		/**
+		 * Encoding of stored values of given storage type.
+		 *
+		 * Scaled types keep one scale factor per row, so that the largest
+		 * value of the row maps to the largest encodable value.
+		 */
+		template<typename V>
+		struct ValueStorage
+		{
+			static const bool SCALED = false;
+
+			/** @return Scale of a row with given largest absolute value */
+			static double scale(double)
+			{
+				return 1.0;
+			}
+
+			static V encode(double value)
+			{
+				return static_cast<V>(value);
+			}
+
+			template<typename A>
+			static A decode(V value)
+			{
+				return static_cast<A>(value);
+			}
+		};
+
+
+		template<>
+		struct ValueStorage<int8_t>
+		{
+			static const bool SCALED = true;
+			static const int LIMIT = 127; // symmetric range, -128 is never used
+
+			static double scale(double largest)
+			{
+				return largest > 0.0 ? largest / LIMIT : 1.0;
+			}
+
+			/** @param value already divided by the row scale */
+			static int8_t encode(double value)
+			{
+				return static_cast<int8_t>(std::max<double>(-LIMIT, std::min<double>(LIMIT, std::round(value))));
+			}
+
+			template<typename A>
+			static A decode(int8_t value)
+			{
+				return static_cast<A>(value);
+			}
+		};
+
+
+    // === HALF ==============================================
+
+    inline Half::Half(float value)
+    {
+        uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+
+        uint32_t sign = (f >> 16) & 0x8000;
+        uint32_t magnitude = f & 0x7FFFFFFF;
+
+        if (magnitude >= 0x7F800000) { // infinity or NaN (kept quiet)
+            this->bits = sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 : 0);
+
+        } else if (magnitude >= 0x477FF000) { // rounds above 65504
+            this->bits = sign | 0x7C00;
+
+        } else if (magnitude < 0x38800000) { // below 2^-14 - subnormal, multiples of 2^-24
+            float absolute;
+            std::memcpy(&absolute, &magnitude, sizeof(absolute));
+            this->bits = sign | static_cast<uint32_t>(std::nearbyint(absolute * 16777216.0f));
+
+        } else { // round mantissa to nearest even, rebias exponent from 127 to 15
+            magnitude += 0x0FFF + ((magnitude >> 13) & 1);
+            this->bits = sign | ((magnitude - 0x38000000) >> 13);
+        }
+    }
+
+
+    inline Half::operator float(void) const
+    {
+        uint32_t sign = static_cast<uint32_t>(this->bits & 0x8000) << 16;
+        uint32_t exponent = (this->bits >> 10) & 0x1F;
+        uint32_t mantissa = this->bits & 0x03FF;
+
+        if (exponent == 0) {
+            float value = std::ldexp(static_cast<float>(mantissa), -24);
+            return sign ? -value : value;
+        }
+
+        uint32_t f = exponent == 0x1F
+            ? sign | 0x7F800000 | (mantissa << 13)
+            : sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+
+
+    // === BFLOAT16 ==============================================
+
+    inline BFloat16::BFloat16(float value)
+    {
+        uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+
+        if ((f & 0x7FFFFFFF) > 0x7F800000) { // NaN must not round to infinity
+            this->bits = static_cast<uint16_t>((f >> 16) | 0x0040);
+
+        } else { // round to nearest even
+            this->bits = static_cast<uint16_t>((f + 0x7FFF + ((f >> 16) & 1)) >> 16);
+        }
+    }
+
+
+    inline BFloat16::operator float(void) const
+    {
+        uint32_t f = static_cast<uint32_t>(this->bits) << 16;
+
+        float value;
+        std::memcpy(&value, &f, sizeof(value));
+        return value;
+    }
+
+	}
+
+#endif
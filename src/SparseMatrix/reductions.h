@@ -0,0 +1,127 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_REDUCTIONS_H__
+
+	#define	__SPARSEMATRIX_REDUCTIONS_H__
+
+	#include <cstddef>
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Reductions of contiguous value arrays.
+		 *
+		 * Values are folded into several independent partial results, so consecutive
+		 * steps don't depend on each other and the loop vectorizes without allowing
+		 * the compiler to reassociate floating-point operations.
+		 *
+		 * @internal
+		 */
+		namespace Reductions
+		{
+
+			const size_t LANES = 4;
+
+
+			/** @return op over f(value) of all values, identity for no values */
+			template<typename T, typename F, typename Op>
+			T reduce(const T * values, size_t count, const T & identity, F f, Op op)
+			{
+				T lanes[LANES];
+
+				for (size_t l = 0; l < LANES; l++) {
+					lanes[l] = identity;
+				}
+
+				size_t k = 0;
+
+				for (; k + LANES <= count; k += LANES) {
+					for (size_t l = 0; l < LANES; l++) {
+						lanes[l] = op(lanes[l], f(values[k + l]));
+					}
+				}
+
+				for (; k < count; k++) {
+					lanes[0] = op(lanes[0], f(values[k]));
+				}
+
+				for (size_t l = 1; l < LANES; l++) {
+					lanes[0] = op(lanes[0], lanes[l]);
+				}
+
+				return lanes[0];
+			}
+
+
+			struct Identity
+			{
+				template<typename T>
+				T operator () (const T & value) const
+				{
+					return value;
+				}
+			};
+
+
+			struct Absolute
+			{
+				template<typename T>
+				T operator () (const T & value) const
+				{
+					return value < T() ? -value : value;
+				}
+			};
+
+
+			struct Square
+			{
+				template<typename T>
+				T operator () (const T & value) const
+				{
+					return value * value;
+				}
+			};
+
+
+			struct Plus
+			{
+				template<typename T>
+				T operator () (const T & a, const T & b) const
+				{
+					return a + b;
+				}
+			};
+
+
+			struct Minimum
+			{
+				template<typename T>
+				T operator () (const T & a, const T & b) const
+				{
+					return b < a ? b : a;
+				}
+			};
+
+
+			struct Maximum
+			{
+				template<typename T>
+				T operator () (const T & a, const T & b) const
+				{
+					return a < b ? b : a;
+				}
+			};
+
+		}
+
+	}
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SEMIRINGS_H__
+
+	#define	__SPARSEMATRIX_SEMIRINGS_H__
+
+	#include <limits>
+
+
+	namespace Sparse
+	{
+
+		/**
+		 * Semiring is a pair of operations used by the multiplication kernels:
+		 * add() combines partial results, multiply() combines two elements.
+		 * zero() is the identity of add() and the value an empty row reduces to,
+		 * one() is the identity of multiply().
+		 *
+		 * Products over a semiring leave out elements equal to zero(), so zero()
+		 * is the implicit value of missing elements of a result - for MinPlus and
+		 * MaxMin it is "no path", while T() is a regular value (e.g. a path of
+		 * length 0) and stays stored.
+		 */
+
+
+		// standard arithmetic (+, *)
+		template<typename T>
+		struct PlusTimes
+		{
+
+			static constexpr T zero(void)
+			{
+				return T();
+			}
+
+
+			static constexpr T one(void)
+			{
+				return T(1);
+			}
+
+
+			static inline T add(const T & a, const T & b)
+			{
+				return a + b;
+			}
+
+
+			static inline T multiply(const T & a, const T & b)
+			{
+				return a * b;
+			}
+
+		};
+
+
+		// shortest paths (min, +)
+		template<typename T>
+		struct MinPlus
+		{
+
+			static constexpr T zero(void)
+			{
+				return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+			}
+
+
+			static constexpr T one(void)
+			{
+				return T();
+			}
+
+
+			static inline T add(const T & a, const T & b)
+			{
+				return b < a ? b : a;
+			}
+
+
+			static inline T multiply(const T & a, const T & b)
+			{
+				// saturate so that integral "infinity" does not overflow
+				return (a == zero() || b == zero()) ? zero() : a + b;
+			}
+
+		};
+
+
+		// widest paths (max, min)
+		template<typename T>
+		struct MaxMin
+		{
+
+			static constexpr T zero(void)
+			{
+				return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+			}
+
+
+			static constexpr T one(void)
+			{
+				return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+			}
+
+
+			static inline T add(const T & a, const T & b)
+			{
+				return a < b ? b : a;
+			}
+
+
+			static inline T multiply(const T & a, const T & b)
+			{
+				return b < a ? b : a;
+			}
+
+		};
+
+
+		// reachability (or, and) - every non-zero element is treated as true
+		template<typename T>
+		struct OrAnd
+		{
+
+			static constexpr T zero(void)
+			{
+				return T();
+			}
+
+
+			static constexpr T one(void)
+			{
+				return T(1);
+			}
+
+
+			static inline T add(const T & a, const T & b)
+			{
+				return static_cast<T>(!(a == T()) || !(b == T()));
+			}
+
+
+			static inline T multiply(const T & a, const T & b)
+			{
+				return static_cast<T>(!(a == T()) && !(b == T()));
+			}
+
+		};
+
+	}
+
+#endif
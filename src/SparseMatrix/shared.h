@@ -0,0 +1,238 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_SHARED_H__
+
+	#define	__SPARSEMATRIX_SHARED_H__
+
+	#include <atomic>
+	#include <chrono>
+	#include <new>
+	#include <string>
+	#include <thread>
+	#include <cstdint>
+	#include <cerrno>
+	#include <cstring>
+	#include <algorithm>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include "exceptions.h"
+
+
+	namespace Sparse
+	{
+
+		namespace Shared
+		{
+
+			static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "Atomics shared between processes have to be lock-free.");
+
+
+			// shared structures are aligned to cache lines, so processes don't invalidate each other's data
+			const size_t ALIGNMENT = 64;
+
+
+			inline size_t align(size_t bytes)
+			{
+				return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+			}
+
+
+			/** Busy wait step - yields first, then sleeps, so idle processes don't burn a core */
+			inline void pause(size_t & spins)
+			{
+				if (++spins < 1000) {
+					std::this_thread::yield();
+
+				} else {
+					std::this_thread::sleep_for(std::chrono::microseconds(50));
+				}
+			}
+
+
+			/**
+			 * Block of POSIX shared memory mapped into the process.
+			 *
+			 * The object is unlinked right after mapping - processes forked afterwards inherit
+			 * the mapping and the memory is released with the last one of them.
+			 */
+			class SharedMemory
+			{
+
+				public:
+
+					explicit SharedMemory(size_t bytes) : bytes(std::max<size_t>(bytes, 1)), memory(nullptr)
+					{
+						static std::atomic<size_t> counter(0);
+						std::string name = "/sparsematrix-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+
+						int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+						if (fd == -1) {
+							throw SystemException("Cannot create shared memory: " + std::string(strerror(errno)));
+						}
+
+						shm_unlink(name.c_str());
+
+						if (ftruncate(fd, this->bytes) == -1) {
+							close(fd);
+							throw SystemException("Cannot resize shared memory: " + std::string(strerror(errno)));
+						}
+
+						this->memory = mmap(nullptr, this->bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+						close(fd);
+
+						if (this->memory == MAP_FAILED) {
+							throw SystemException("Cannot map shared memory: " + std::string(strerror(errno)));
+						}
+					}
+
+
+					~SharedMemory(void)
+					{
+						munmap(this->memory, this->bytes);
+					}
+
+
+					SharedMemory(const SharedMemory &) = delete;
+					SharedMemory & operator = (const SharedMemory &) = delete;
+
+
+					char * data(void) const
+					{
+						return static_cast<char *>(this->memory);
+					}
+
+
+					size_t size(void) const
+					{
+						return this->bytes;
+					}
+
+
+				protected:
+
+					size_t bytes;
+					void * memory;
+
+			};
+
+
+			/**
+			 * Single-producer single-consumer byte ring placed in shared memory.
+			 *
+			 * Transfers of any length are streamed through the ring in pieces, the writer
+			 * waits for free space and the reader for data. Only the two counters are
+			 * shared, so the same interface can be backed by a network transport.
+			 */
+			class SharedRing
+			{
+
+				public:
+
+					/** @return Bytes of shared memory occupied by a ring of given capacity */
+					static size_t footprint(size_t capacity)
+					{
+						return ALIGNMENT * 2 + align(capacity);
+					}
+
+
+					/** @param initialize true for the first process attaching the memory */
+					SharedRing(char * memory, size_t capacity, bool initialize)
+						: head(reinterpret_cast<std::atomic<uint64_t> *>(memory)),
+						  tail(reinterpret_cast<std::atomic<uint64_t> *>(memory + ALIGNMENT)),
+						  buffer(memory + ALIGNMENT * 2),
+						  capacity(capacity)
+					{
+						if (capacity == 0) {
+							throw InvalidArgumentException("Ring capacity has to be positive.");
+						}
+
+						if (initialize) {
+							new (this->head) std::atomic<uint64_t>(0);
+							new (this->tail) std::atomic<uint64_t>(0);
+						}
+					}
+
+
+					size_t getCapacity(void) const
+					{
+						return this->capacity;
+					}
+
+
+					void write(const void * data, size_t bytes)
+					{
+						const char * source = static_cast<const char *>(data);
+						uint64_t written = this->head->load(std::memory_order_relaxed);
+						size_t spins = 0;
+
+						while (bytes > 0) {
+							size_t free = this->capacity - (written - this->tail->load(std::memory_order_acquire));
+
+							if (free == 0) {
+								pause(spins);
+								continue;
+							}
+
+							size_t offset = written % this->capacity;
+							size_t chunk = std::min(std::min(bytes, free), this->capacity - offset);
+
+							std::memcpy(this->buffer + offset, source, chunk);
+							this->head->store(written + chunk, std::memory_order_release);
+
+							written += chunk;
+							source += chunk;
+							bytes -= chunk;
+							spins = 0;
+						}
+					}
+
+
+					void read(void * data, size_t bytes)
+					{
+						char * target = static_cast<char *>(data);
+						uint64_t consumed = this->tail->load(std::memory_order_relaxed);
+						size_t spins = 0;
+
+						while (bytes > 0) {
+							size_t available = this->head->load(std::memory_order_acquire) - consumed;
+
+							if (available == 0) {
+								pause(spins);
+								continue;
+							}
+
+							size_t offset = consumed % this->capacity;
+							size_t chunk = std::min(std::min(bytes, available), this->capacity - offset);
+
+							std::memcpy(target, this->buffer + offset, chunk);
+							this->tail->store(consumed + chunk, std::memory_order_release);
+
+							consumed += chunk;
+							target += chunk;
+							bytes -= chunk;
+							spins = 0;
+						}
+					}
+
+
+				protected:
+
+					std::atomic<uint64_t> * head, * tail; // bytes written / read so far
+					char * buffer;
+					size_t capacity;
+
+			};
+
+		}
+
+	}
+
+#endif
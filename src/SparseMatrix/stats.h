@@ -0,0 +1,239 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#ifndef __SPARSEMATRIX_STATS_H__
+
+	#define	__SPARSEMATRIX_STATS_H__
+
+	#include <atomic>
+	#include <chrono>
+	#include <cstdint>
+	#include <iostream>
+
+
+	/**
+	 * Operation statistics are collected only when SPARSEMATRIX_STATS is defined
+	 * before including the library. Otherwise the hooks below expand to nothing.
+	 *
+	 * The library is header-only, so the macro changes the bodies of its inline
+	 * functions and templates. Define it for every translation unit of a program
+	 * (e.g. -DSPARSEMATRIX_STATS on the command line) or for none - mixing both
+	 * breaks the one definition rule and the linker keeps an arbitrary variant.
+	 */
+	#ifdef SPARSEMATRIX_STATS
+
+		#define SPARSEMATRIX_STATS_TIME(operation) Sparse::StatsTimer sparseStatsTimer(Sparse::Stats::operation)
+		#define SPARSEMATRIX_STATS_SHIFTED(operation, count) Sparse::Stats::instance().recordShifted(Sparse::Stats::operation, count)
+		#define SPARSEMATRIX_STATS_ALLOCATED(bytes) Sparse::Stats::instance().recordAllocation(bytes)
+		#define SPARSEMATRIX_STATS_NNZ(nnz) Sparse::Stats::instance().recordNnz(nnz)
+
+	#else
+
+		#define SPARSEMATRIX_STATS_TIME(operation)
+		#define SPARSEMATRIX_STATS_SHIFTED(operation, count)
+		#define SPARSEMATRIX_STATS_ALLOCATED(bytes)
+		#define SPARSEMATRIX_STATS_NNZ(nnz)
+
+	#endif
+
+
+	namespace Sparse
+	{
+
+		class Stats
+		{
+
+			public:
+
+				enum Operation
+				{
+					GET,
+					SET,
+					INSERT,
+					REMOVE,
+					MULTIPLY_VECTOR,
+					MULTIPLY_MATRIX,
+					ADD,
+					SUBTRACT,
+					OPERATION_COUNT
+				};
+
+
+				struct Counters
+				{
+					uint64_t calls;
+					uint64_t nanoseconds;
+					uint64_t shifted; // elements moved by insert/remove
+				};
+
+
+				struct Report
+				{
+					Counters operations[OPERATION_COUNT];
+					uint64_t bytesAllocated;
+					uint64_t nnzHighWater;
+
+					void toJson(std::ostream & os) const;
+				};
+
+
+				static Stats & instance(void);
+				static const char * getName(Operation operation);
+
+				Report report(void) const;
+				void reset(void);
+
+				void record(Operation operation, uint64_t nanoseconds);
+				void recordShifted(Operation operation, uint64_t count);
+				void recordAllocation(uint64_t bytes);
+				void recordNnz(uint64_t nnz);
+
+
+			protected:
+
+				Stats(void);
+
+				std::atomic<uint64_t> calls[OPERATION_COUNT];
+				std::atomic<uint64_t> nanoseconds[OPERATION_COUNT];
+				std::atomic<uint64_t> shifted[OPERATION_COUNT];
+				std::atomic<uint64_t> bytesAllocated;
+				std::atomic<uint64_t> nnzHighWater;
+
+		};
+
+
+		/** Adds time spent in the enclosing scope to given operation */
+		class StatsTimer
+		{
+
+			public:
+
+				explicit StatsTimer(Stats::Operation operation) : operation(operation), start(std::chrono::steady_clock::now())
+				{}
+
+
+				~StatsTimer(void)
+				{
+					std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - this->start;
+					Stats::instance().record(this->operation, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+				}
+
+
+			protected:
+
+				Stats::Operation operation;
+				std::chrono::steady_clock::time_point start;
+
+		};
+
+
+    inline Stats::Stats(void)
+    {
+        this->reset();
+    }
+
+
+    inline Stats & Stats::instance(void)
+    {
+        static Stats stats;
+        return stats;
+    }
+
+
+    inline const char * Stats::getName(Operation operation)
+    {
+        static const char * names[OPERATION_COUNT] = {
+            "get", "set", "insert", "remove", "multiplyVector", "multiplyMatrix", "add", "subtract"
+        };
+
+        return names[operation];
+    }
+
+
+    inline Stats::Report Stats::report(void) const
+    {
+        Report report;
+
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            report.operations[op].calls = this->calls[op].load(std::memory_order_relaxed);
+            report.operations[op].nanoseconds = this->nanoseconds[op].load(std::memory_order_relaxed);
+            report.operations[op].shifted = this->shifted[op].load(std::memory_order_relaxed);
+        }
+
+        report.bytesAllocated = this->bytesAllocated.load(std::memory_order_relaxed);
+        report.nnzHighWater = this->nnzHighWater.load(std::memory_order_relaxed);
+
+        return report;
+    }
+
+
+    inline void Stats::reset(void)
+    {
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            this->calls[op] = 0;
+            this->nanoseconds[op] = 0;
+            this->shifted[op] = 0;
+        }
+
+        this->bytesAllocated = 0;
+        this->nnzHighWater = 0;
+    }
+
+
+    inline void Stats::record(Operation operation, uint64_t nanoseconds)
+    {
+        this->calls[operation].fetch_add(1, std::memory_order_relaxed);
+        this->nanoseconds[operation].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+
+    inline void Stats::recordShifted(Operation operation, uint64_t count)
+    {
+        this->shifted[operation].fetch_add(count, std::memory_order_relaxed);
+    }
+
+
+    inline void Stats::recordAllocation(uint64_t bytes)
+    {
+        this->bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+
+    inline void Stats::recordNnz(uint64_t nnz)
+    {
+        uint64_t highWater = this->nnzHighWater.load(std::memory_order_relaxed);
+
+        while (nnz > highWater && !this->nnzHighWater.compare_exchange_weak(highWater, nnz, std::memory_order_relaxed)) {
+            // highWater reloaded by compare_exchange_weak
+        }
+    }
+
+
+    inline void Stats::Report::toJson(std::ostream & os) const
+    {
+        os << "{\"operations\": {";
+
+        for (int op = 0; op < OPERATION_COUNT; op++) {
+            if (op != 0) {
+                os << ", ";
+            }
+
+            os << "\"" << Stats::getName(static_cast<Operation>(op)) << "\": {"
+                << "\"calls\": " << this->operations[op].calls
+                << ", \"nanoseconds\": " << this->operations[op].nanoseconds
+                << ", \"shifted\": " << this->operations[op].shifted
+                << "}";
+        }
+
+        os << "}, \"bytesAllocated\": " << this->bytesAllocated
+            << ", \"nnzHighWater\": " << this->nnzHighWater << "}";
+    }
+
+	}
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void _reserveFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	m.reserve(std::vector<size_t>(4, 1));
+}
+
+
+void testReserveFail(void)
+{
+	std::cout << "reserve() fail..." << std::flush;
+	assertException("InvalidDimensionsException", _reserveFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testCapacity(void)
+{
+	std::cout << "capacity..." << std::flush;
+
+	SparseMatrixMock<int> m(3, 4);
+	Sparse::SparseMatrix<int> empty(3, 4);
+
+	assertEquals<size_t>(0, m.memoryUsage().vals);
+	assertEquals<size_t>(4 * sizeof(size_t), m.memoryUsage().rows);
+
+	// reserved but still empty matrix equals to fresh one
+	m.reserve(10);
+	assertEquals<size_t>(10, m.getValues()->capacity());
+	assertEquals<size_t>(10, m.getColumnPointers()->capacity());
+	assertEquals<Sparse::SparseMatrix<int> >(empty, m);
+
+	// insertions within capacity do not reallocate
+	const int * storage = m.getValues()->data();
+	for (size_t i = 0; i < 3; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			m.set(1, i, j);
+		}
+	}
+
+	assertEquals<size_t>(9, m.getNnz());
+	assertEquals<bool>(true, storage == m.getValues()->data(), "Values reallocated within reserved capacity");
+
+	Sparse::SparseMatrix<int>::MemoryUsage usage = m.memoryUsage();
+	assertEquals<size_t>(10 * sizeof(int), usage.vals);
+	assertEquals<size_t>(10 * sizeof(size_t), usage.cols);
+	assertEquals<size_t>(sizeof(Sparse::SparseMatrix<int>) + usage.rows + usage.cols + usage.vals, usage.total);
+
+	// per-row hints never drop below current row sizes
+	std::vector<size_t> hints { 1, 5, 0 };
+	m.reserve(hints);
+	assertEquals<size_t>(11, m.getValues()->capacity());
+
+	m.shrinkToFit();
+	assertEquals<size_t>(9, m.getValues()->capacity());
+	assertEquals<size_t>(9, m.getColumnPointers()->capacity());
+
+	// removing all elements and shrinking releases values completely
+	for (size_t i = 0; i < 3; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			m.set(0, i, j);
+		}
+	}
+
+	assertEquals<Sparse::SparseMatrix<int> >(empty, m);
+
+	m.shrinkToFit();
+	assertEquals<bool>(true, m.getValues() == nullptr);
+	assertEquals<size_t>(0, m.memoryUsage().vals);
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,222 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cmath>
+#include <limits>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/CholeskySolver.h"
+
+
+void _choleskySquareFail(void)
+{
+	Sparse::SparseMatrix<double> m(3, 4);
+	Sparse::CholeskySolver<double> solver(m);
+}
+
+
+void _choleskyPivotFail(void)
+{
+	Sparse::SparseMatrix<double> m(2);
+	m.set(1.0, 0, 0).set(1.0, 0, 1).set(1.0, 1, 0).set(1.0, 1, 1);
+
+	Sparse::CholeskySolver<double> solver(m);
+	solver.factor(m);
+}
+
+
+void _choleskyTinyPivotFail(void)
+{
+	// second pivot is only the rounding error of 1 + eps - 1
+	Sparse::SparseMatrix<double> m(2);
+	m.set(1.0, 0, 0).set(1.0, 0, 1).set(1.0, 1, 0).set(1.0 + std::numeric_limits<double>::epsilon(), 1, 1);
+
+	Sparse::CholeskySolver<double> solver(m, Sparse::CholeskySolver<double>::NATURAL);
+	solver.factor(m);
+}
+
+
+void _choleskyPatternFail(void)
+{
+	Sparse::SparseMatrix<double> m(3);
+	m.set(1.0, 0, 0).set(1.0, 1, 1).set(1.0, 2, 2);
+	Sparse::CholeskySolver<double> solver(m);
+
+	m.set(0.5, 2, 0).set(0.5, 0, 2);
+	solver.factor(m);
+}
+
+
+void _choleskyNotFactorizedFail(void)
+{
+	Sparse::SparseMatrix<double> m(3);
+	m.set(1.0, 0, 0).set(1.0, 1, 1).set(1.0, 2, 2);
+
+	Sparse::CholeskySolver<double> solver(m);
+	solver.solve(std::vector<double>(3, 1.0));
+}
+
+
+void testCholeskyFail(void)
+{
+	std::cout << "cholesky fail..." << std::flush;
+	assertException("InvalidDimensionsException", _choleskySquareFail);
+	assertException("InvalidArgumentException", _choleskyPivotFail);
+	assertException("InvalidArgumentException", _choleskyTinyPivotFail);
+	assertException("InvalidArgumentException", _choleskyPatternFail);
+	assertException("InvalidArgumentException", _choleskyNotFactorizedFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+/** @return Largest residual element of matrix * x - b */
+double choleskyResidual(const Sparse::SparseMatrix<double> & matrix, const std::vector<double> & x, const std::vector<double> & b)
+{
+	std::vector<double> product = matrix * x;
+	double residual = 0.0;
+
+	for (size_t i = 0; i < b.size(); i++) {
+		residual = std::max(residual, std::abs(product[i] - b[i]));
+	}
+
+	return residual;
+}
+
+
+void testCholeskySolve(void)
+{
+	std::cout << "cholesky solve..." << std::flush;
+
+	typedef Sparse::CholeskySolver<double> Solver;
+
+	// random symmetric diagonally dominant matrix
+	const size_t n = 80;
+	Sparse::SparseMatrix<double> a(n);
+	std::vector<double> b(n);
+
+	for (size_t i = 0; i < n; i++) {
+		b[i] = rand() % 21 - 10;
+
+		for (int k = 0; k < 3; k++) {
+			size_t j = rand() % n;
+			double value = (rand() % 201 - 100) / 100.0 + 0.005;
+
+			if (i != j) {
+				a.set(value, i, j).set(value, j, i);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		a.set(10.0 + rand() % 5, i, i);
+	}
+
+	for (int ordering = 0; ordering < 2; ordering++) {
+		Solver solver(a, ordering ? Solver::MINIMUM_DEGREE : Solver::NATURAL);
+		assertEquals<bool>(false, solver.isFactorized());
+
+		solver.factor(a);
+		assertEquals<bool>(true, solver.isPositiveDefinite());
+
+		if (choleskyResidual(a, solver.solve(b), b) > 1e-9) {
+			throw FailureException("Incorrect cholesky solve");
+		}
+
+		// refactorization with the same pattern
+		Sparse::SparseMatrix<double> shifted = a;
+		for (size_t i = 0; i < n; i++) {
+			shifted.set(a.get(i, i) * 2.0, i, i);
+		}
+
+		solver.factor(shifted);
+
+		if (choleskyResidual(shifted, solver.solve(b), b) > 1e-9) {
+			throw FailureException("Incorrect cholesky solve after refactorization");
+		}
+	}
+
+	// symmetric indefinite matrix still has LDLᵀ factorization
+	Sparse::SparseMatrix<double> indefinite(2);
+	indefinite.set(1.0, 0, 0).set(2.0, 0, 1).set(2.0, 1, 0).set(1.0, 1, 1);
+
+	Solver solver(indefinite, Solver::NATURAL);
+	solver.factor(indefinite);
+
+	assertEquals<bool>(false, solver.isPositiveDefinite());
+	assertEquals<std::vector<double> >(std::vector<double>{ 1, 1 }, solver.solve(std::vector<double>{ 3, 3 }));
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testCholeskyOrdering(void)
+{
+	std::cout << "cholesky ordering..." << std::flush;
+
+	typedef Sparse::CholeskySolver<double> Solver;
+
+	// arrow matrix with the dense row first fills L completely unless reordered
+	const size_t n = 50;
+	Sparse::SparseMatrix<double> arrow(n);
+
+	for (size_t i = 0; i < n; i++) {
+		arrow.set(n, i, i);
+
+		if (i > 0) {
+			arrow.set(1.0, 0, i).set(1.0, i, 0);
+		}
+	}
+
+	Solver natural(arrow, Solver::NATURAL), reordered(arrow);
+	assertEquals<size_t>(n * (n - 1) / 2, natural.getFactorNnz());
+	assertEquals<size_t>(n - 1, reordered.getFactorNnz());
+
+	// long dense row is set aside and ordered last
+	const size_t wide = 2000;
+	Sparse::SparseMatrix<double> star(wide);
+
+	for (size_t i = wide; i-- > 0; ) {
+		star.set(wide, i, i);
+
+		if (i > 0) {
+			star.set(1.0, i, 0).set(1.0, 0, i);
+		}
+	}
+
+	Solver hub(star);
+	assertEquals<size_t>(wide - 1, hub.getFactorNnz());
+	assertEquals<size_t>(0, hub.getPermutation()[wide - 1]);
+
+	// 2D Laplacian of a grid
+	const size_t side = 15, m = side * side;
+	Sparse::SparseMatrix<double> grid(m);
+	std::vector<double> b(m);
+
+	for (size_t i = 0; i < m; i++) {
+		grid.set(4.0, i, i);
+		b[i] = rand() % 21 - 10;
+
+		if (i % side > 0) {
+			grid.set(-1.0, i, i - 1).set(-1.0, i - 1, i);
+		}
+
+		if (i >= side) {
+			grid.set(-1.0, i, i - side).set(-1.0, i - side, i);
+		}
+	}
+
+	Solver band(grid, Solver::NATURAL), ordered(grid);
+	assertEquals<bool>(true, ordered.getFactorNnz() < band.getFactorNnz());
+
+	ordered.factor(grid);
+
+	if (choleskyResidual(grid, ordered.solve(b), b) > 1e-9) {
+		throw FailureException("Incorrect cholesky solve of reordered matrix");
+	}
+
+	std::cout << " OK" << std::endl;
+}
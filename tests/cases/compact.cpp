@@ -0,0 +1,140 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cmath>
+#include <limits>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/CompactSparseMatrix.h"
+
+
+void _compactMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<double> m(3, 4);
+	Sparse::CompactSparseMatrix<float> compact(m);
+	compact.multiply(std::vector<double>(3));
+}
+
+
+void testCompactFail(void)
+{
+	std::cout << "compact matrix fail..." << std::flush;
+	assertException("InvalidDimensionsException", _compactMultiplicationFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testHalfPrecision(void)
+{
+	std::cout << "half / bfloat16 conversions..." << std::flush;
+
+	// exactly representable values survive the round trip
+	float exact[] = { 0.0f, 1.0f, -2.5f, 0.333251953125f, 65504.0f, std::ldexp(1.0f, -14), std::ldexp(1.0f, -24), -std::ldexp(3.0f, -20) };
+	for (float value : exact) {
+		assertEquals<float>(value, static_cast<float>(Sparse::Half(value)), "Incorrect half round trip");
+	}
+
+	assertEquals<uint16_t>(0x3C00, Sparse::Half(1.0f).bits);
+	assertEquals<uint16_t>(0x3C00, Sparse::Half(1.0f + std::ldexp(1.0f, -11)).bits, "Tie not rounded to even");
+	assertEquals<uint16_t>(0x3C02, Sparse::Half(1.0f + std::ldexp(3.0f, -11)).bits, "Tie not rounded to even");
+	assertEquals<uint16_t>(0x7C00, Sparse::Half(70000.0f).bits, "Overflow not rounded to infinity");
+	assertEquals<uint16_t>(0xFC00, Sparse::Half(-std::numeric_limits<float>::infinity()).bits);
+	assertEquals<bool>(true, std::isnan(static_cast<float>(Sparse::Half(std::numeric_limits<float>::quiet_NaN()))));
+	assertEquals<float>(0.0f, static_cast<float>(Sparse::Half(std::ldexp(1.0f, -26))), "Underflow not rounded to zero");
+
+	float bexact[] = { 0.0f, 1.0f, -3.140625f, std::ldexp(1.0f, 100), std::ldexp(-1.5f, -100) };
+	for (float value : bexact) {
+		assertEquals<float>(value, static_cast<float>(Sparse::BFloat16(value)), "Incorrect bfloat16 round trip");
+	}
+
+	assertEquals<uint16_t>(0x3F80, Sparse::BFloat16(1.0f + std::ldexp(1.0f, -8)).bits, "Tie not rounded to even");
+	assertEquals<bool>(true, std::isnan(static_cast<float>(Sparse::BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+
+	std::cout << " OK" << std::endl;
+}
+
+
+template<typename V, typename A>
+void assertCompactMultiplication(const Sparse::SparseMatrix<double> & matrix, const std::vector<double> & x, double epsilon)
+{
+	Sparse::CompactSparseMatrix<V, A> compact(matrix);
+	assertEquals<size_t>(matrix.getNnz(), compact.getNnz());
+
+	std::vector<double> expected = matrix.multiply(x);
+	std::vector<A> y = compact.multiply(std::vector<A>(x.begin(), x.end()));
+
+	// error of every row is bounded by relative precision of stored values
+	for (size_t i = 0; i < matrix.getRowCount(); i++) {
+		double bound = 0.0;
+		for (size_t j = 0; j < matrix.getColumnCount(); j++) {
+			bound += std::abs(matrix.get(i, j) * x[j]);
+		}
+
+		if (std::abs(static_cast<double>(y[i]) - expected[i]) > epsilon * bound + 1e-12) {
+			throw FailureException("Compact multiplication is not accurate enough");
+		}
+	}
+
+	Sparse::SparseMatrix<A> decoded = compact.toMatrix();
+	for (size_t k = 0; k < 20; k++) {
+		size_t row = rand() % matrix.getRowCount(), col = rand() % matrix.getColumnCount();
+		assertEquals<A>(compact.get(row, col), decoded.get(row, col));
+
+		if (std::abs(static_cast<double>(compact.get(row, col)) - matrix.get(row, col)) > epsilon * std::abs(matrix.get(row, col)) + 1e-12) {
+			throw FailureException("Compact value is not accurate enough");
+		}
+	}
+}
+
+
+void testCompactMultiplication(void)
+{
+	std::cout << "compact vector multiplication..." << std::flush;
+
+	Sparse::SparseMatrix<double> empty(3, 2);
+	assertEquals<std::vector<double> >(std::vector<double>(3, 0.0), Sparse::CompactSparseMatrix<int8_t>(empty) * std::vector<double>(2, 1.0));
+
+	for (int s = 0; s < 2; s++) {
+		size_t rows = s == 0 ? 40 : 3000, cols = s == 0 ? 30 : 2000;
+		Sparse::SparseMatrix<double> matrix(rows, cols);
+
+		for (size_t k = 0; k < rows * 12; k++) {
+			matrix.set((rand() % 20001 - 10000) / 1000.0 + 0.0005, rand() % rows, rand() % cols);
+		}
+
+		std::vector<double> x(cols);
+		for (size_t j = 0; j < cols; j++) {
+			x[j] = (rand() % 2001 - 1000) / 100.0;
+		}
+
+		assertCompactMultiplication<float, double>(matrix, x, 1e-7);
+		assertCompactMultiplication<float, float>(matrix, x, 1e-5);
+		assertCompactMultiplication<Sparse::Half, double>(matrix, x, 1.0 / 2048);
+		assertCompactMultiplication<Sparse::BFloat16, double>(matrix, x, 1.0 / 256);
+		assertCompactMultiplication<int8_t, double>(matrix, x, 1.0);
+
+		// int8 error is relative to the largest value of the row
+		Sparse::CompactSparseMatrix<int8_t> quantized(matrix);
+		std::vector<double> expected = matrix.multiply(x), y = quantized.multiply(x);
+
+		for (size_t i = 0; i < rows; i++) {
+			double largest = 0.0, bound = 0.0;
+			for (size_t j = 0; j < cols; j++) {
+				largest = std::max(largest, std::abs(matrix.get(i, j)));
+				bound += std::abs(x[j]);
+			}
+
+			if (std::abs(y[i] - expected[i]) > largest / 254 * bound + 1e-9) {
+				throw FailureException("Quantized multiplication is not accurate enough");
+			}
+		}
+
+		assertEquals<bool>(true, Sparse::CompactSparseMatrix<Sparse::Half>(matrix).memoryUsage().vals < matrix.memoryUsage().vals / 3);
+	}
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,118 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void _compositionFail1(void)
+{
+	Sparse::SparseMatrix<int> a(3, 4), b(3, 5);
+	Sparse::SparseMatrix<int>::vstack({ a, b });
+}
+
+
+void _compositionFail2(void)
+{
+	Sparse::SparseMatrix<int> a(3, 4);
+	Sparse::SparseMatrix<int>::block({ { &a, nullptr }, { nullptr, nullptr } });
+}
+
+
+void testCompositionFail(void)
+{
+	std::cout << "composition fail..." << std::flush;
+	assertException("InvalidDimensionsException", _compositionFail1);
+	assertException("InvalidDimensionsException", _compositionFail2);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testComposition(void)
+{
+	std::cout << "composition..." << std::flush;
+
+	std::vector<std::vector<int> > classicA = generateRandomMatrix<int>(3, 4);
+	std::vector<std::vector<int> > classicB = generateRandomMatrix<int>(2, 4);
+	std::vector<std::vector<int> > classicC = generateRandomMatrix<int>(3, 2);
+
+	classicA[1] = std::vector<int>(4, 0); // empty row
+	classicB[0][1] = 0;
+
+	SparseMatrixMock<int> a = SparseMatrixMock<int>::fromVectors(classicA);
+	SparseMatrixMock<int> b = SparseMatrixMock<int>::fromVectors(classicB);
+	SparseMatrixMock<int> c = SparseMatrixMock<int>::fromVectors(classicC);
+
+	// [ A ]
+	// [ B ]
+	std::vector<std::vector<int> > classicVertical = classicA;
+	classicVertical.insert(classicVertical.end(), classicB.begin(), classicB.end());
+
+	Sparse::SparseMatrix<int> vertical = Sparse::SparseMatrix<int>::vstack({ a, b });
+	assertEquals<size_t>(5, vertical.getRowCount());
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(vertical, classicVertical, "Incorrect vertical stacking");
+
+	// [ A C ]
+	std::vector<std::vector<int> > classicHorizontal = classicA;
+	for (size_t i = 0; i < 3; i++) {
+		classicHorizontal[i].insert(classicHorizontal[i].end(), classicC[i].begin(), classicC[i].end());
+	}
+
+	Sparse::SparseMatrix<int> horizontal = Sparse::SparseMatrix<int>::hstack({ a, c });
+	assertEquals<size_t>(6, horizontal.getColumnCount());
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(horizontal, classicHorizontal, "Incorrect horizontal stacking");
+
+	// KKT system
+	// [ A  C ]
+	// [ B  0 ]
+	Sparse::SparseMatrix<int> kkt = Sparse::SparseMatrix<int>::block({ { &a, &c }, { &b, nullptr } });
+
+	std::vector<std::vector<int> > classicKkt = classicHorizontal;
+	for (size_t i = 0; i < 2; i++) {
+		classicKkt.push_back(classicB[i]);
+		classicKkt.back().resize(6, 0);
+	}
+
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(kkt, classicKkt, "Incorrect block composition");
+
+	// result is the same as when set element by element
+	Sparse::SparseMatrix<int> manual(5, 6);
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = 0; j < 6; j++) {
+			manual.set(classicKkt[i][j], i, j);
+		}
+	}
+
+	assertEquals<Sparse::SparseMatrix<int> >(manual, kkt, "Incorrect internal storage of block composition");
+
+	// [ A 0 ]
+	// [ 0 B ]
+	Sparse::SparseMatrix<int> diagonal = Sparse::SparseMatrix<int>::blockDiag({ a, b });
+	assertEquals<size_t>(5, diagonal.getRowCount());
+	assertEquals<size_t>(8, diagonal.getColumnCount());
+
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = 0; j < 8; j++) {
+			int expected = i < 3 ? (j < 4 ? classicA[i][j] : 0) : (j < 4 ? 0 : classicB[i - 3][j - 4]);
+			assertEquals<int>(expected, diagonal.get(i, j), "Incorrect block diagonal composition");
+		}
+	}
+
+	// Kronecker product
+	Sparse::SparseMatrix<int> product = Sparse::SparseMatrix<int>::kron(b, c);
+	assertEquals<size_t>(6, product.getRowCount());
+	assertEquals<size_t>(8, product.getColumnCount());
+
+	for (size_t i = 0; i < 6; i++) {
+		for (size_t j = 0; j < 8; j++) {
+			assertEquals<int>(classicB[i / 3][j / 2] * classicC[i % 3][j % 2], product.get(i, j), "Incorrect Kronecker product");
+		}
+	}
+
+	std::cout << " OK" << std::endl;
+}
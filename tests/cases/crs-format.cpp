@@ -164,3 +164,39 @@ void testColumnMatrix()
     assertEquals<std::vector<size_t> >(columnPointersxx, *(xx.getColumnPointers()), "Incorrect internal column pointers");
 
 }
+
+
+void testTranspose()
+{
+    std::cout << "transpose..." << std::flush;
+
+    /*
+     [ 1  0 4 5 ]
+     [ 2 -1 0 0 ]
+     [ 0  0 3 2 ]
+     */
+    SparseMatrixMock<int> m1(3, 4);
+    m1.set(1, 0, 0)
+        .set(4, 0, 2)
+        .set(5, 0, 3)
+        .set(2, 1, 0)
+        .set(-1, 1, 1)
+        .set(3, 2, 2)
+        .set(2, 2, 3);
+
+    SparseMatrixMock<int> t(m1.transpose());
+    assertEquals<size_t>(4, t.getRowCount());
+    assertEquals<size_t>(3, t.getColumnCount());
+
+    std::vector<size_t> rowPointers { 0, 2, 3, 5, 7 };
+    assertEquals<std::vector<size_t> >(rowPointers, *(t.getRowPointers()), "Incorrect internal row pointers");
+    std::vector<size_t> columnPointers { 0, 1, 1, 0, 2, 0, 2 };
+    assertEquals<std::vector<size_t> >(columnPointers, *(t.getColumnPointers()), "Incorrect internal column pointers");
+    std::vector<int> values { 1, 2, -1, 4, 3, 5, 2 };
+    assertEquals<std::vector<int> >(values, *(t.getValues()), "Incorrect internal values storage");
+
+    assertEquals<Sparse::SparseMatrix<int> >(m1, t.transpose());
+    assertEquals<Sparse::SparseMatrix<int> >(Sparse::SparseMatrix<int>(4, 2), Sparse::SparseMatrix<int>(2, 4).transpose());
+
+    std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,105 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../../src/SparseMatrix/DeltaSparseMatrix.h"
+
+
+void _deltaMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::DeltaSparseMatrix<int> delta(m);
+	delta.multiply(std::vector<int>(3, 1));
+}
+
+
+void _deltaGetFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::DeltaSparseMatrix<int> delta(m);
+	delta.get(3, 0);
+}
+
+
+void _deltaGapFail(void)
+{
+	Sparse::SparseMatrix<int> m(2, static_cast<size_t>(1) << 33);
+	m.set(1, 1, 0).set(2, 1, (static_cast<size_t>(1) << 33) - 1);
+	Sparse::DeltaSparseMatrix<int> delta(m);
+}
+
+
+void testDeltaFail(void)
+{
+	std::cout << "delta matrix fail..." << std::flush;
+	assertException("InvalidDimensionsException", _deltaMultiplicationFail);
+	assertException("InvalidCoordinatesException", _deltaGetFail);
+	assertException("InvalidArgumentException", _deltaGapFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testDeltaMultiplication(void)
+{
+	std::cout << "delta vector multiplication..." << std::flush;
+
+	// gaps of all widths, long rows span several units
+	Sparse::SparseMatrix<int> wide(4, 300000);
+	wide.set(1, 0, 0).set(2, 0, 1).set(3, 0, 200).set(4, 0, 1000).set(5, 0, 70000).set(6, 0, 299999);
+	wide.set(7, 2, 150000);
+
+	for (size_t j = 0; j < 500; j += 3) {
+		wide.set(static_cast<int>(j % 7) + 1, 3, 100 + j);
+	}
+
+	Sparse::DeltaSparseMatrix<int> compressed(wide);
+	assertEquals<Sparse::SparseMatrix<int> >(wide, compressed.toMatrix());
+	assertEquals<int>(5, compressed.get(0, 70000));
+	assertEquals<int>(0, compressed.get(1, 5));
+	assertEquals<int>(0, compressed.get(0, 2));
+
+	std::vector<int> x = generateRandomVector<int>(300000);
+	assertEquals<std::vector<int> >(wide * x, compressed * x, "Incorrect delta vector multiplication");
+
+	// more columns than 32 bits can address, the gaps still fit
+	const size_t far = (static_cast<size_t>(1) << 33) - 2;
+	Sparse::SparseMatrix<int> huge(2, far + 2);
+	huge.set(3, 0, far).set(4, 0, far + 1).set(5, 1, 7);
+
+	Sparse::DeltaSparseMatrix<int> compressedHuge(huge);
+	assertEquals<int>(4, compressedHuge.get(0, far + 1));
+	assertEquals<int>(5, compressedHuge.get(1, 7));
+	assertEquals<int>(0, compressedHuge.get(1, far));
+
+	// random matrix large enough to run in parallel
+	Sparse::SparseMatrix<int> matrix(2000, 5000);
+	for (int k = 0; k < 40000; k++) {
+		matrix.set(rand() % 101 - 50, rand() % 2000, rand() % 5000);
+	}
+
+	Sparse::DeltaSparseMatrix<int> delta(matrix);
+	std::vector<int> y = generateRandomVector<int>(5000);
+
+	assertEquals<size_t>(matrix.getNnz(), delta.getNnz());
+	assertEquals<std::vector<int> >(matrix * y, delta * y, "Incorrect delta vector multiplication");
+	assertEquals<std::vector<int> >(matrix.multiply<Sparse::MinPlus<int> >(y), delta.multiply<Sparse::MinPlus<int> >(y), "Incorrect delta (min, +) vector multiplication");
+
+	// banded matrix needs about a byte per index
+	Sparse::SparseMatrix<double> band(1000);
+	for (size_t i = 0; i < 1000; i++) {
+		for (size_t j = (i < 3 ? 0 : i - 3); j < std::min<size_t>(i + 4, 1000); j++) {
+			band.set(1.0, i, j);
+		}
+	}
+
+	Sparse::DeltaSparseMatrix<double> banded(band);
+	assertEquals<bool>(true, banded.getIndexBytes() * 4 < band.getNnz() * sizeof(size_t), "Indices not compressed enough");
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,97 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../../src/SparseMatrix/DiagonalSparseMatrix.h"
+
+
+void _diagonalMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::DiagonalSparseMatrix<int> diagonal(m);
+	diagonal.multiply(std::vector<int>(3, 1));
+}
+
+
+void testDiagonalFail(void)
+{
+	std::cout << "diagonal matrix fail..." << std::flush;
+	assertException("InvalidDimensionsException", _diagonalMultiplicationFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testDiagonalMatrix(void)
+{
+	std::cout << "diagonal matrix..." << std::flush;
+
+	typedef Sparse::DiagonalSparseMatrix<double> Diagonal;
+
+	// 2D 5-point stencil
+	const size_t side = 100, n = side * side;
+	Sparse::SparseMatrix<double> stencil(n);
+
+	for (size_t i = 0; i < n; i++) {
+		stencil.set(4.0, i, i);
+
+		if (i % side > 0) {
+			stencil.set(-1.0, i, i - 1).set(-1.0, i - 1, i);
+		}
+
+		if (i >= side) {
+			stencil.set(-1.0, i, i - side).set(-1.0, i - side, i);
+		}
+	}
+
+	assertEquals<bool>(true, Diagonal::isSuitable(stencil));
+	assertEquals<bool>(true, Diagonal::fillRatio(stencil) < 1.05);
+
+	Diagonal dia(stencil);
+	assertEquals<size_t>(5, dia.getDiagonalCount());
+	assertEquals<std::vector<std::ptrdiff_t> >(std::vector<std::ptrdiff_t>{ -100, -1, 0, 1, 100 }, dia.getOffsets());
+	assertEquals<double>(-1.0, dia.get(side, 0));
+	assertEquals<double>(0.0, dia.get(side, 1));
+	assertEquals<Sparse::SparseMatrix<double> >(stencil, dia.toMatrix());
+
+	std::vector<double> x(n);
+	for (size_t i = 0; i < n; i++) {
+		x[i] = rand() % 21 - 10;
+	}
+
+	assertEquals<std::vector<double> >(stencil * x, dia * x, "Incorrect diagonal vector multiplication");
+
+	// rectangular matrices, diagonals on both sides
+	int sizes[][2] = { { 7, 3 }, { 3, 7 }, { 40, 40 } };
+
+	for (int s = 0; s < 3; s++) {
+		size_t rows = sizes[s][0], cols = sizes[s][1];
+		Sparse::SparseMatrix<int> matrix(rows, cols);
+
+		for (int k = 0; k < 20; k++) {
+			matrix.set(rand() % 101 - 50, rand() % rows, rand() % cols);
+		}
+
+		Sparse::DiagonalSparseMatrix<int> converted(matrix);
+		std::vector<int> v = generateRandomVector<int>(cols);
+
+		assertEquals<Sparse::SparseMatrix<int> >(matrix, converted.toMatrix());
+		assertEquals<std::vector<int> >(matrix * v, converted * v, "Incorrect diagonal vector multiplication");
+	}
+
+	// scattered elements would be mostly padding
+	Sparse::SparseMatrix<double> scattered(1000);
+	for (size_t i = 0; i < 1000; i += 10) {
+		scattered.set(1.0, i, (i * 37) % 1000);
+	}
+
+	assertEquals<bool>(false, Diagonal::isSuitable(scattered));
+	assertEquals<bool>(true, Diagonal::isSuitable(Sparse::SparseMatrix<double>(5)));
+
+	std::cout << " OK" << std::endl;
+}
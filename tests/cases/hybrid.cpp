@@ -0,0 +1,104 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../../src/SparseMatrix/HybridSparseMatrix.h"
+
+
+void _hybridMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::HybridSparseMatrix<int> hybrid(m);
+	hybrid.multiply(std::vector<int>(3, 1));
+}
+
+
+void _hybridGetFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::HybridSparseMatrix<int> hybrid(m);
+	hybrid.get(3, 0);
+}
+
+
+void testHybridFail(void)
+{
+	std::cout << "hybrid matrix fail..." << std::flush;
+	assertException("InvalidDimensionsException", _hybridMultiplicationFail);
+	assertException("InvalidCoordinatesException", _hybridGetFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testHybridMultiplication(void)
+{
+	std::cout << "hybrid vector multiplication..." << std::flush;
+
+	typedef Sparse::HybridSparseMatrix<int> Hybrid;
+
+	// power-law like - short random rows and three hub rows, filled in row order
+	const size_t rows = 3000, cols = 60000;
+	Sparse::SparseMatrix<int> matrix(rows, cols);
+
+	for (size_t i = 0; i < rows - 3; i++) {
+		for (size_t j = rand() % 20; j < cols; j += rand() % 20000 + 1) {
+			matrix.set(rand() % 21 - 10, i, j);
+		}
+	}
+
+	size_t steps[] = { 2, 3, 6 };
+
+	for (size_t h = 0; h < 3; h++) {
+		for (size_t j = h; j < cols; j += steps[h]) {
+			matrix.set(static_cast<int>(j % 13) - 6, rows - 3 + h, j);
+		}
+	}
+
+	Hybrid hybrid(matrix);
+	assertEquals<std::vector<size_t> >(std::vector<size_t>{ rows - 3, rows - 2, rows - 1 }, hybrid.getHubRows());
+	assertEquals<size_t>(matrix.getNnz(), hybrid.getNnz());
+	assertEquals<Sparse::SparseMatrix<int> >(matrix, hybrid.toMatrix());
+	assertEquals<int>(matrix.get(rows - 2, 4), hybrid.get(rows - 2, 4));
+	assertEquals<int>(0, hybrid.get(rows - 2, 3));
+
+	std::vector<int> x = generateRandomVector<int>(cols);
+	std::vector<int> expected = matrix * x;
+	std::vector<int> expectedMinPlus = matrix.multiply<Sparse::MinPlus<int> >(x);
+
+	// tiny threshold moves most rows into the tail, so range boundaries split both short and hub rows
+	Hybrid allTail(matrix, 2);
+	assertEquals<Sparse::SparseMatrix<int> >(matrix, allTail.toMatrix());
+
+	size_t threads[] = { 1, 4 };
+
+	for (size_t t = 0; t < 2; t++) {
+		Sparse::Parallel::setThreadCount(threads[t]);
+
+		assertEquals<std::vector<int> >(expected, hybrid * x, "Incorrect hybrid vector multiplication");
+		assertEquals<std::vector<int> >(expected, allTail * x, "Incorrect hybrid vector multiplication with long tail");
+		assertEquals<std::vector<int> >(expectedMinPlus, hybrid.multiply<Sparse::MinPlus<int> >(x), "Incorrect hybrid (min, +) vector multiplication");
+		assertEquals<std::vector<int> >(expectedMinPlus, allTail.multiply<Sparse::MinPlus<int> >(x), "Incorrect hybrid (min, +) vector multiplication with long tail");
+	}
+
+	Sparse::Parallel::setThreadCount(0);
+
+	// regular matrix has no tail
+	Sparse::SparseMatrix<int> small(50, 40);
+	for (int k = 0; k < 300; k++) {
+		small.set(rand() % 21 - 10, rand() % 50, rand() % 40);
+	}
+
+	Hybrid regular(small);
+	assertEquals<size_t>(0, regular.getTailNnz());
+
+	std::vector<int> y = generateRandomVector<int>(40);
+	assertEquals<std::vector<int> >(small * y, regular * y, "Incorrect hybrid vector multiplication");
+
+	std::cout << " OK" << std::endl;
+}
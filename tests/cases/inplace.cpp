@@ -0,0 +1,128 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void _axpyFail(void)
+{
+	Sparse::SparseMatrix<int> a(3, 4), b(4, 3);
+	a.axpy(2, b);
+}
+
+
+void _hadamardFail(void)
+{
+	Sparse::SparseMatrix<int> a(3, 4), b(3, 5);
+	a.hadamard(b);
+}
+
+
+void testInPlaceFail(void)
+{
+	std::cout << "in-place operations fail..." << std::flush;
+	assertException("InvalidDimensionsException", _axpyFail);
+	assertException("InvalidDimensionsException", _hadamardFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+std::vector<std::vector<int> > generateSparseRandomMatrix(int rows, int columns)
+{
+	std::vector<std::vector<int> > matrix = generateRandomMatrix<int>(rows, columns);
+
+	for (int i = 0; i < rows; i++) {
+		for (int j = 0; j < columns; j++) {
+			if (rand() % 2) {
+				matrix[i][j] = 0;
+			}
+		}
+	}
+
+	return matrix;
+}
+
+
+void testInPlace(void)
+{
+	for (int N = 0; N < 1e3; N++) {
+		std::cout << "\rin-place operations... #" << N + 1 << std::flush;
+
+		int rows = rand() % 16 + 1;
+		int cols = rand() % 16 + 1;
+		int alpha = rand() % 7 - 3;
+
+		std::vector<std::vector<int> > classicA = generateSparseRandomMatrix(rows, cols);
+		std::vector<std::vector<int> > classicB = generateSparseRandomMatrix(rows, cols);
+		SparseMatrixMock<int> a = SparseMatrixMock<int>::fromVectors(classicA);
+		SparseMatrixMock<int> b = SparseMatrixMock<int>::fromVectors(classicB);
+
+		std::vector<std::vector<int> > scaled = classicA, axpy = classicA, product = classicA;
+		for (int i = 0; i < rows; i++) {
+			for (int j = 0; j < cols; j++) {
+				scaled[i][j] = alpha * classicA[i][j];
+				axpy[i][j] = classicA[i][j] + alpha * classicB[i][j];
+				product[i][j] = classicA[i][j] * classicB[i][j];
+			}
+		}
+
+		// results have to be stored exactly as if built by set()
+		Sparse::SparseMatrix<int> result = a;
+		assertEquals<Sparse::SparseMatrix<int> >(SparseMatrixMock<int>::fromVectors(scaled), result.scale(alpha), "Incorrect in-place scaling");
+
+		result = a;
+		assertEquals<Sparse::SparseMatrix<int> >(SparseMatrixMock<int>::fromVectors(axpy), result.axpy(alpha, b), "Incorrect in-place axpy");
+
+		result = a;
+		assertEquals<Sparse::SparseMatrix<int> >(SparseMatrixMock<int>::fromVectors(product), result.hadamard(b), "Incorrect in-place element-wise product");
+
+		// same pattern
+		Sparse::SparseMatrix<int> twice = a;
+		twice.apply([] (int val) { return 2 * val; });
+
+		result = a;
+		assertEquals<Sparse::SparseMatrix<int> >(a.add(twice), result.axpy(2, a), "Incorrect in-place axpy (same pattern)");
+
+		result = a;
+		assertEquals<Sparse::SparseMatrix<int> >(Sparse::SparseMatrix<int>(rows, cols), result.axpy(-1, a), "Incorrect in-place axpy (cancellation)");
+
+		// pattern of b within pattern of a keeps the arrays of a
+		Sparse::SparseMatrix<int> subset = a;
+		subset.apply([] (int val) { return val % 3 == 0 ? 0 : val; });
+
+		Sparse::SparseMatrix<int> scaledSubset = subset;
+		scaledSubset.scale(alpha);
+
+		SparseMatrixMock<int> target = SparseMatrixMock<int>::fromVectors(classicA);
+		std::vector<int> * values = target.getValues();
+		std::vector<size_t> * columns = target.getColumnPointers();
+
+		target.axpy(alpha, subset);
+		assertEquals<Sparse::SparseMatrix<int> >(a.add(scaledSubset), target, "Incorrect in-place axpy (subset pattern)");
+		assertEquals<bool>(true, values == target.getValues(), "Values reallocated by axpy of a subset pattern");
+		assertEquals<bool>(true, columns == target.getColumnPointers(), "Columns reallocated by axpy of a subset pattern");
+
+		// zeros produced by the function are removed
+		result = a;
+		result.apply([] (int val) { return val % 2 == 0 ? 0 : val; });
+
+		for (int i = 0; i < rows; i++) {
+			for (int j = 0; j < cols; j++) {
+				if (classicA[i][j] % 2 == 0) {
+					classicA[i][j] = 0;
+				}
+			}
+		}
+
+		assertEquals<Sparse::SparseMatrix<int> >(SparseMatrixMock<int>::fromVectors(classicA), result, "Incorrect in-place function application");
+	}
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,98 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void _maskedMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> a(3, 4), b(4, 5), mask(3, 4);
+	a.multiplyMasked(b, mask);
+}
+
+
+void testMaskedMultiplicationFail(void)
+{
+	std::cout << "multiplyMasked() fail..." << std::flush;
+	assertException("InvalidDimensionsException", _maskedMultiplicationFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+Sparse::SparseMatrix<int> filterByMask(const Sparse::SparseMatrix<int> & product, const Sparse::SparseMatrix<int> & mask, bool complement)
+{
+	Sparse::SparseMatrix<int> result(product.getRowCount(), product.getColumnCount());
+
+	for (size_t i = 0; i < product.getRowCount(); i++) {
+		for (size_t j = 0; j < product.getColumnCount(); j++) {
+			if ((mask.get(i, j) != 0) != complement) {
+				result.set(product.get(i, j), i, j);
+			}
+		}
+	}
+
+	return result;
+}
+
+
+void testMaskedMultiplication(void)
+{
+	std::cout << "masked matrices multiplication..." << std::flush;
+
+	/*
+		Triangle counting - undirected graph with triangles {0, 1, 2} and {1, 2, 3}
+
+		0 - 1
+		| / |
+		2 - 3
+	*/
+
+	Sparse::SparseMatrix<int> lower(4);
+	lower.set(1, 1, 0).set(1, 2, 0).set(1, 2, 1).set(1, 3, 1).set(1, 3, 2);
+
+	Sparse::SparseMatrix<int> wedges = lower.multiplyMasked(lower, lower);
+
+	int triangles = 0;
+	for (size_t i = 0; i < 4; i++) {
+		for (size_t j = 0; j < 4; j++) {
+			triangles += wedges.get(i, j);
+		}
+	}
+
+	assertEquals<int>(2, triangles, "Incorrect triangle count");
+
+	// random matrices of various densities, small and large enough to run in parallel
+	int sizes[] = { 8, 40, 300 };
+	int fills[] = { 10, 500, 8000 };
+
+	for (int s = 0; s < 3; s++) {
+		int size = sizes[s];
+
+		Sparse::SparseMatrix<int> a(size, size + 3), b(size + 3, size), mask(size);
+		for (int k = 0; k < fills[s]; k++) {
+			a.set(rand() % 21 - 10, rand() % size, rand() % (size + 3));
+			b.set(rand() % 21 - 10, rand() % (size + 3), rand() % size);
+			mask.set(1, rand() % size, rand() % size);
+		}
+
+		// short mask rows favour dot products
+		Sparse::SparseMatrix<int> sparseMask(size);
+		for (int k = 0; k < size / 2; k++) {
+			sparseMask.set(1, rand() % size, rand() % size);
+		}
+
+		Sparse::SparseMatrix<int> product = a.multiply(b);
+
+		assertEquals<Sparse::SparseMatrix<int> >(filterByMask(product, mask, false), a.multiplyMasked(b, mask), "Incorrect masked multiplication");
+		assertEquals<Sparse::SparseMatrix<int> >(filterByMask(product, mask, true), a.multiplyMasked(b, mask, true), "Incorrect complement masked multiplication");
+		assertEquals<Sparse::SparseMatrix<int> >(filterByMask(product, sparseMask, false), a.multiplyMasked(b, sparseMask), "Incorrect masked multiplication");
+	}
+
+	std::cout << " OK" << std::endl;
+}
@@ -106,3 +106,67 @@ void testMatricesMultiplication(void)
 
 	std::cout << " OK" << std::endl;
 }
+
+
+void testParallelMatricesMultiplication(void)
+{
+	std::cout << "parallel matrices multiplication..." << std::flush;
+
+	// large enough to be split between threads
+	SparseMatrixMock<int> a(400, 300), b(300, 500);
+
+	for (int k = 0; k < 6000; k++) {
+		a.set(rand() % 101 - 50, rand() % 400, rand() % 300);
+		b.set(rand() % 101 - 50, rand() % 300, rand() % 500);
+	}
+
+	Sparse::Parallel::setThreadCount(1);
+	Sparse::SparseMatrix<int> sequential = a.multiply(b);
+
+	Sparse::Parallel::setThreadCount(4);
+	assertEquals<Sparse::SparseMatrix<int> >(sequential, a.multiply(b), "Incorrect parallel matrices multiplication");
+
+	Sparse::Parallel::setThreadCount(0);
+
+	// compare with dense multiplication
+	std::vector<std::vector<int> > classicA(400, std::vector<int>(300)), classicB(300, std::vector<int>(500));
+	for (size_t i = 0; i < 400; i++) {
+		for (size_t j = 0; j < 300; j++) {
+			classicA[i][j] = a.get(i, j);
+		}
+	}
+
+	for (size_t i = 0; i < 300; i++) {
+		for (size_t j = 0; j < 500; j++) {
+			classicB[i][j] = b.get(i, j);
+		}
+	}
+
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(sequential, multiplyMatrices(classicA, classicB), "Incorrect parallel matrices multiplication");
+
+	// very wide right matrix uses hashed accumulator
+	Sparse::SparseMatrix<int> c(3, 4), d(4, 1 << 20);
+	c.set(1, 0, 0).set(2, 0, 3).set(5, 2, 1);
+	d.set(3, 0, 1000000).set(7, 0, 17).set(-1, 1, 17).set(4, 3, 1000000).set(2, 3, 5);
+
+	SparseMatrixMock<int> wide(c.multiply(d));
+	std::vector<size_t> wideRows { 0, 3, 3, 4 };
+	std::vector<size_t> wideCols { 5, 17, 1000000, 17 };
+	std::vector<int> wideVals { 4, 7, 11, -5 };
+	assertEquals<std::vector<size_t> >(wideRows, *(wide.getRowPointers()), "Incorrect internal row pointers");
+	assertEquals<std::vector<size_t> >(wideCols, *(wide.getColumnPointers()), "Incorrect internal column pointers");
+	assertEquals<std::vector<int> >(wideVals, *(wide.getValues()), "Incorrect internal values storage");
+
+	// elements which cancel out are not stored
+	Sparse::SparseMatrix<int> e(2), f(2);
+	e.set(1, 0, 0).set(1, 0, 1).set(3, 1, 0);
+	f.set(1, 0, 0).set(-1, 1, 0).set(2, 1, 1);
+
+	SparseMatrixMock<int> cancelled(e.multiply(f));
+	std::vector<size_t> cancelledRows { 0, 1, 2 };
+	std::vector<int> cancelledVals { 2, 3 };
+	assertEquals<std::vector<size_t> >(cancelledRows, *(cancelled.getRowPointers()), "Incorrect internal row pointers");
+	assertEquals<std::vector<int> >(cancelledVals, *(cancelled.getValues()), "Incorrect internal values storage");
+
+	std::cout << " OK" << std::endl;
+}
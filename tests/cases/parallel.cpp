@@ -0,0 +1,136 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/SparseMatrix.h"
+
+
+void _parallelExceptionFail(void)
+{
+	std::vector<size_t> bounds{ 0, 1, 2, 3, 4 };
+
+	Sparse::Parallel::run(bounds, [] (size_t part, size_t, size_t) {
+		if (part == 2) {
+			throw Sparse::InvalidArgumentException("Task failed.");
+		}
+	});
+}
+
+
+void testThreadPool(void)
+{
+	std::cout << "thread pool..." << std::flush;
+
+	Sparse::Parallel::setThreadCount(4);
+
+	// every item exactly once, weighted chunks
+	const size_t n = 20000;
+	std::vector<size_t> work(n + 1, 0);
+	for (size_t i = 0; i < n; i++) {
+		work[i + 1] = work[i] + 1 + rand() % 20;
+	}
+
+	std::vector<int> visited(n, 0);
+	std::atomic<size_t> chunks(0);
+
+	Sparse::Parallel::parallelFor(work, [&] (size_t begin, size_t end) {
+		chunks++;
+
+		for (size_t i = begin; i < end; i++) {
+			visited[i]++;
+		}
+	});
+
+	assertEquals<std::vector<int> >(std::vector<int>(n, 1), visited, "Items not visited exactly once");
+	assertEquals<bool>(true, chunks > 4, "Work not split into several chunks per thread");
+
+	// nested calls are run by the same workers
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+	std::atomic<size_t> inner(0);
+
+	Sparse::Parallel::run(std::vector<size_t>{ 0, 1, 2, 3, 4, 5, 6, 7, 8 }, [&] (size_t, size_t, size_t) {
+		Sparse::Parallel::parallelFor(work, [&] (size_t begin, size_t end) {
+			inner += end - begin;
+
+			std::lock_guard<std::mutex> lock(mutex);
+			threads.insert(std::this_thread::get_id());
+		});
+	});
+
+	assertEquals<size_t>(8 * n, inner);
+	assertEquals<bool>(true, threads.size() <= 4, "Nested calls started new threads");
+
+	assertException("InvalidArgumentException", _parallelExceptionFail);
+
+	// pinned workers
+	Sparse::Parallel::setAffinity(std::vector<size_t>{ 0 });
+	std::fill(visited.begin(), visited.end(), 0);
+
+	Sparse::Parallel::parallelFor(work, [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			visited[i]++;
+		}
+	});
+
+	assertEquals<std::vector<int> >(std::vector<int>(n, 1), visited, "Items not visited exactly once by pinned workers");
+
+	Sparse::Parallel::setAffinity(std::vector<size_t>());
+	Sparse::Parallel::setThreadCount(0);
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testParallelKernels(void)
+{
+	std::cout << "parallel kernels..." << std::flush;
+
+	Sparse::SparseMatrix<int> a(1000, 800), b(1000, 800);
+
+	for (int k = 0; k < 40000; k++) {
+		a.set(rand() % 101 - 50, rand() % 1000, rand() % 800);
+		b.set(rand() % 101 - 50, rand() % 1000, rand() % 800);
+	}
+
+	std::vector<int> x(800);
+	for (size_t j = 0; j < x.size(); j++) {
+		x[j] = rand() % 21 - 10;
+	}
+
+	Sparse::Parallel::setThreadCount(1);
+	std::vector<int> product = a * x;
+	Sparse::SparseMatrix<int> sum = a + b, difference = a - b, transposed = a.transpose();
+	Sparse::SparseMatrix<int> stacked = Sparse::SparseMatrix<int>::vstack({ a, b });
+
+	Sparse::Parallel::setThreadCount(4);
+	assertEquals<std::vector<int> >(product, a * x, "Incorrect parallel vector multiplication");
+	assertEquals<Sparse::SparseMatrix<int> >(sum, a + b, "Incorrect parallel addition");
+	assertEquals<Sparse::SparseMatrix<int> >(difference, a - b, "Incorrect parallel subtraction");
+	assertEquals<Sparse::SparseMatrix<int> >(transposed, a.transpose(), "Incorrect parallel transposition");
+	assertEquals<Sparse::SparseMatrix<int> >(stacked, Sparse::SparseMatrix<int>::vstack({ a, b }), "Incorrect parallel composition");
+
+	Sparse::Parallel::setThreadCount(0);
+
+	// elements which cancel out are not stored
+	assertEquals<size_t>(0, (a - a).getNnz());
+
+	for (size_t k = 0; k < 200; k++) {
+		size_t i = rand() % 1000, j = rand() % 800;
+
+		assertEquals<int>(a.get(i, j) + b.get(i, j), sum.get(i, j));
+		assertEquals<int>(a.get(i, j), transposed.get(j, i));
+	}
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,122 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cstdint>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/PartitionedSparseMatrix.h"
+
+
+void _partitionedSquareFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::PartitionedSparseMatrix<int> partitioned(m, 2);
+}
+
+
+void _partitionedPartsFail(void)
+{
+	Sparse::SparseMatrix<int> m(3);
+	Sparse::PartitionedSparseMatrix<int> partitioned(m, 0);
+}
+
+
+void _partitionedMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> m(3);
+	Sparse::PartitionedSparseMatrix<int> partitioned(m, 2);
+	partitioned.multiply(std::vector<int>(4, 1));
+}
+
+
+void testPartitionedFail(void)
+{
+	std::cout << "partitioned matrix fail..." << std::flush;
+	assertException("InvalidDimensionsException", _partitionedSquareFail);
+	assertException("InvalidArgumentException", _partitionedPartsFail);
+	assertException("InvalidDimensionsException", _partitionedMultiplicationFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testSharedRing(void)
+{
+	std::cout << "shared memory ring..." << std::flush;
+
+	Sparse::Shared::SharedMemory memory(Sparse::Shared::SharedRing::footprint(12));
+	Sparse::Shared::SharedRing ring(memory.data(), 12, true);
+
+	// transfers wrap around the end of the ring
+	for (uint32_t k = 0; k < 5; k++) {
+		uint32_t sent[2] = { k, 100 + k }, received[2] = { 0, 0 };
+
+		ring.write(sent, sizeof(sent));
+		ring.read(received, sizeof(received));
+
+		assertEquals<uint32_t>(k, received[0]);
+		assertEquals<uint32_t>(100 + k, received[1]);
+	}
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testPartitionedMultiplication(void)
+{
+	std::cout << "partitioned vector multiplication..." << std::flush;
+
+	// tridiagonal matrix needs one ghost from each neighbouring block
+	const size_t n = 12;
+	Sparse::SparseMatrix<int> tridiagonal(n);
+	std::vector<int> x(n);
+
+	for (size_t i = 0; i < n; i++) {
+		tridiagonal.set(2, i, i);
+		x[i] = i + 1;
+
+		if (i > 0) {
+			tridiagonal.set(-1, i, i - 1).set(-1, i - 1, i);
+		}
+	}
+
+	{
+		Sparse::PartitionedSparseMatrix<int> partitioned(tridiagonal, 3);
+		assertEquals<size_t>(3, partitioned.getPartCount());
+
+		const Sparse::PartitionedSparseMatrix<int>::Block & middle = partitioned.getBlock(1);
+		assertEquals<std::vector<size_t> >(std::vector<size_t>{ middle.firstRow - 1, middle.lastRow }, middle.ghosts);
+		assertEquals<size_t>(4, partitioned.getHaloSize());
+
+		assertEquals<std::vector<int> >(tridiagonal * x, partitioned * x);
+	}
+
+	// random matrix, repeated multiplications reuse the workers and rings
+	const size_t m = 2000;
+	Sparse::SparseMatrix<int> a(m);
+	std::vector<int> v(m);
+
+	for (size_t i = 0; i < m; i++) {
+		v[i] = rand() % 5 - 2;
+		a.set(rand() % 11 - 5, i, i);
+
+		for (int k = 0; k < 4; k++) {
+			a.set(rand() % 11 - 5, i, rand() % m);
+		}
+	}
+
+	Sparse::PartitionedSparseMatrix<int> partitioned(a, 4);
+
+	std::vector<int> expected = v, actual = v;
+	for (int k = 0; k < 3; k++) {
+		expected = a * expected;
+		actual = partitioned * actual;
+
+		assertEquals<std::vector<int> >(expected, actual, "Incorrect partitioned vector multiplication");
+	}
+
+	std::cout << " OK" << std::endl;
+}
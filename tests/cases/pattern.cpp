@@ -0,0 +1,277 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/SparsePattern.h"
+
+
+void _patternFail(void)
+{
+	Sparse::SparsePattern p(3, 4);
+	p.insert(3, 0);
+}
+
+
+void testPatternFail(void)
+{
+	std::cout << "pattern insert() fail..." << std::flush;
+	assertException("InvalidCoordinatesException", _patternFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testPattern(void)
+{
+	std::cout << "pattern..." << std::flush;
+
+	/*
+		[ x . x ]
+		[ . . . ]
+		[ x x . ]
+	*/
+
+	Sparse::SparsePattern a(3);
+	assertEquals<bool>(true, a.insert(2, 1));
+	assertEquals<bool>(true, a.insert(0, 2));
+	assertEquals<bool>(true, a.insert(0, 0));
+	assertEquals<bool>(true, a.insert(2, 0));
+	assertEquals<bool>(false, a.insert(0, 2));
+	assertEquals<size_t>(4, a.getNnz());
+
+	assertEquals<bool>(true, a.contains(0, 2));
+	assertEquals<bool>(false, a.contains(1, 1));
+
+	assertEquals<bool>(true, a.insert(1, 1));
+	assertEquals<bool>(true, a.erase(1, 1));
+	assertEquals<bool>(false, a.erase(1, 1));
+
+	// pattern of a matrix
+	Sparse::SparseMatrix<int> matrix(3);
+	matrix.set(5, 0, 0).set(-1, 0, 2).set(2, 2, 0).set(7, 2, 1);
+	assertEquals<Sparse::SparsePattern>(a, Sparse::SparsePattern(matrix));
+
+	/*
+		[ . x . ]
+		[ . x . ]
+		[ . . x ]
+	*/
+
+	Sparse::SparsePattern b(3);
+	b.insert(0, 1);
+	b.insert(1, 1);
+	b.insert(2, 2);
+
+	Sparse::SparsePattern sum(3);
+	sum.insert(0, 0);
+	sum.insert(0, 1);
+	sum.insert(0, 2);
+	sum.insert(1, 1);
+	sum.insert(2, 0);
+	sum.insert(2, 1);
+	sum.insert(2, 2);
+	assertEquals<Sparse::SparsePattern>(sum, a | b, "Incorrect pattern union");
+
+	Sparse::SparsePattern common(3);
+	assertEquals<Sparse::SparsePattern>(common, a & b, "Incorrect pattern intersection");
+	assertEquals<Sparse::SparsePattern>(b, sum & b, "Incorrect pattern intersection");
+
+	// boolean product
+	Sparse::SparsePattern product(3);
+	product.insert(0, 1);
+	product.insert(0, 2);
+	product.insert(2, 1);
+	assertEquals<Sparse::SparsePattern>(product, a * b, "Incorrect pattern multiplication");
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void _sharedPatternFail(void)
+{
+	std::shared_ptr<const Sparse::SparsePattern> pattern = std::make_shared<const Sparse::SparsePattern>(3);
+	Sparse::SparseMatrix<int> m(pattern, std::vector<int>(1, 5));
+}
+
+
+void _numericMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> a(2), b(2);
+	a.set(1, 0, 1);
+	b.set(1, 1, 0);
+
+	// product has element (0, 0) which the pattern of result lacks
+	Sparse::SparseMatrix<int> result(std::make_shared<const Sparse::SparsePattern>(b));
+	a.multiplyInto(b, result);
+}
+
+
+void _numericAdditionFail(void)
+{
+	Sparse::SparseMatrix<int> a(2), b(2);
+	a.set(1, 0, 1);
+	b.set(1, 1, 0);
+
+	Sparse::SparseMatrix<int> result(std::make_shared<const Sparse::SparsePattern>(a));
+	a.addInto(b, result);
+}
+
+
+void testSharedPatternFail(void)
+{
+	std::cout << "shared pattern fail..." << std::flush;
+	assertException("InvalidDimensionsException", _sharedPatternFail);
+	assertException("InvalidArgumentException", _numericMultiplicationFail);
+	assertException("InvalidArgumentException", _numericAdditionFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testSharedPattern(void)
+{
+	std::cout << "shared pattern..." << std::flush;
+
+	Sparse::SparseMatrix<int> matrix(4, 5);
+	matrix.set(1, 0, 0).set(2, 0, 3).set(3, 2, 1).set(4, 3, 4);
+
+	std::shared_ptr<const Sparse::SparsePattern> pattern = std::make_shared<const Sparse::SparsePattern>(matrix);
+
+	// several matrices reference one pattern, values are their own
+	Sparse::SparseMatrix<int> a(pattern, std::vector<int>{ 1, 2, 3, 4 });
+	Sparse::SparseMatrix<int> b(pattern);
+	Sparse::SparseMatrix<int> c(a);
+
+	assertEquals<Sparse::SparseMatrix<int> >(matrix, a);
+	assertEquals<size_t>(4, b.getNnz());
+	assertEquals<int>(0, b.get(0, 3));
+	assertEquals<bool>(true, a.getSharedPattern() == pattern && b.getSharedPattern() == pattern && c.getSharedPattern() == pattern);
+	assertEquals<bool>(true, matrix.getSharedPattern() == nullptr);
+
+	// values change in place, zeros stay stored so the pattern is kept
+	b.setValues(std::vector<int>{ 5, 0, 7, 8 });
+	b.set(9, 0, 3);
+	assertEquals<int>(9, b.get(0, 3));
+	b.set(0, 2, 1).scale(2);
+	assertEquals<size_t>(4, b.getNnz());
+	assertEquals<int>(0, b.get(2, 1));
+	assertEquals<bool>(true, b.getSharedPattern() == pattern);
+
+	// new element gives the matrix its own copy of the structure
+	c.set(6, 1, 1);
+	assertEquals<bool>(true, c.getSharedPattern() == nullptr);
+	assertEquals<size_t>(5, c.getNnz());
+	assertEquals<int>(6, c.get(1, 1));
+	assertEquals<size_t>(4, pattern->getNnz());
+	assertEquals<Sparse::SparseMatrix<int> >(matrix, a);
+
+	// assigning replaces the shared structure
+	c = b;
+	assertEquals<bool>(true, c.getSharedPattern() == pattern);
+	c = matrix;
+	assertEquals<bool>(true, c.getSharedPattern() == nullptr);
+	assertEquals<Sparse::SparseMatrix<int> >(matrix, c);
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testNumericOperations(void)
+{
+	std::cout << "symbolic / numeric operations..." << std::flush;
+
+	std::vector<std::vector<int> > classicA = generateRandomMatrix<int>(30, 20), classicB = generateRandomMatrix<int>(20, 25), classicC = generateRandomMatrix<int>(30, 20);
+
+	for (std::vector<std::vector<int> > * classic : { &classicA, &classicB, &classicC }) {
+		for (size_t i = 0; i < classic->size(); i++) {
+			for (size_t j = 0; j < (*classic)[i].size(); j++) {
+				if (rand() % 4 != 0) {
+					(*classic)[i][j] = 0;
+				}
+			}
+		}
+	}
+
+	Sparse::SparseMatrix<int> a(30, 20), b(20, 25), c(30, 20);
+	a.setValues(std::vector<int>()); // empty matrix, nothing to set
+
+	for (size_t i = 0; i < 30; i++) {
+		for (size_t j = 0; j < 20; j++) {
+			a.set(classicA[i][j], i, j);
+			c.set(classicC[i][j], i, j);
+		}
+	}
+
+	for (size_t i = 0; i < 20; i++) {
+		for (size_t j = 0; j < 25; j++) {
+			b.set(classicB[i][j], i, j);
+		}
+	}
+
+	// symbolic phase once
+	std::shared_ptr<const Sparse::SparsePattern> productPattern = std::make_shared<const Sparse::SparsePattern>(Sparse::SparsePattern(a) * Sparse::SparsePattern(b));
+	std::shared_ptr<const Sparse::SparsePattern> sumPattern = std::make_shared<const Sparse::SparsePattern>(Sparse::SparsePattern(a) | Sparse::SparsePattern(c));
+
+	Sparse::SparseMatrix<int> product(productPattern), sum(sumPattern);
+
+	// numeric phase on every step, values change but patterns don't
+	for (int step = 1; step <= 3; step++) {
+		a.scale(step);
+		c.scale(-step);
+
+		for (size_t i = 0; i < 30; i++) {
+			for (size_t j = 0; j < 20; j++) {
+				classicA[i][j] = a.get(i, j);
+				classicC[i][j] = c.get(i, j);
+			}
+		}
+
+		a.multiplyInto(b, product);
+		a.addInto(c, sum);
+
+		assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(product, multiplyMatrices(classicA, classicB), "Incorrect numeric multiplication");
+		assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(sum, addMatrices(classicA, classicC), "Incorrect numeric addition");
+		assertEquals<bool>(true, product.getSharedPattern() == productPattern && sum.getSharedPattern() == sumPattern);
+	}
+
+	// result can be an operand, the wider pattern works too
+	Sparse::SparseMatrix<int> accumulated(sumPattern);
+	a.addInto(accumulated, accumulated);
+	a.addInto(accumulated, accumulated);
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(accumulated, addMatrices(classicA, classicA), "Incorrect numeric addition into operand");
+
+	// very wide result is searched instead of mapped
+	Sparse::SparseMatrix<int> left(3, 4), right(4, 100000);
+	left.set(2, 0, 1).set(3, 2, 1).set(-1, 2, 3);
+	right.set(5, 1, 99999).set(7, 1, 3).set(1, 3, 3);
+
+	Sparse::SparseMatrix<int> wide(std::make_shared<const Sparse::SparsePattern>(Sparse::SparsePattern(left) * Sparse::SparsePattern(right)));
+	left.multiplyInto(right, wide);
+	assertEquals<Sparse::SparseMatrix<int> >(left * right, wide);
+
+	// result with its own pattern keeps an element which cancelled out for the next step
+	Sparse::SparseMatrix<int> row(1, 2), column(2, 1), other(1, 2);
+	row.set(1, 0, 0).set(1, 0, 1);
+	column.set(1, 0, 0).set(-1, 1, 0);
+	other.set(-1, 0, 0).set(-1, 0, 1);
+
+	Sparse::SparseMatrix<int> dot(row * column), total(row);
+	dot.set(1, 0, 0);
+
+	row.multiplyInto(column, dot);
+	row.addInto(other, total);
+	assertEquals<int>(0, dot.get(0, 0));
+	assertEquals<int>(0, total.get(0, 1));
+
+	column.set(2, 1, 0);
+	other.set(1, 0, 1);
+	row.multiplyInto(column, dot);
+	row.addInto(other, total);
+	assertEquals<int>(3, dot.get(0, 0));
+	assertEquals<int>(2, total.get(0, 1));
+
+	std::cout << " OK" << std::endl;
+}
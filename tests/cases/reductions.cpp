@@ -0,0 +1,124 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cmath>
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+
+
+void _spectralNormFail(void)
+{
+	Sparse::SparseMatrix<double> m(3);
+	m.norm(Sparse::SparseMatrix<double>::NORM_2);
+}
+
+
+void testReductionsFail(void)
+{
+	std::cout << "reductions fail..." << std::flush;
+	assertException("InvalidArgumentException", _spectralNormFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testReductions(void)
+{
+	std::cout << "reductions..." << std::flush;
+
+	typedef Sparse::SparseMatrix<int> Matrix;
+
+	/*
+		[  1  0 -2  0 ]
+		[  0  0  0  0 ]
+		[  3 -4  5  0 ]
+	*/
+
+	Matrix m(3, 4);
+	m.set(1, 0, 0).set(-2, 0, 2).set(3, 2, 0).set(-4, 2, 1).set(5, 2, 2);
+
+	assertEquals<std::vector<int> >(std::vector<int>{ -1, 0, 4 }, m.rowSums());
+	assertEquals<std::vector<int> >(std::vector<int>{ 4, -4, 3, 0 }, m.columnSums());
+	assertEquals<std::vector<int> >(std::vector<int>{ 3, 0, 12 }, m.rowNorms(Matrix::NORM_1));
+	assertEquals<std::vector<int> >(std::vector<int>{ 2, 0, 5 }, m.rowNorms(Matrix::NORM_INF));
+	assertEquals<std::vector<size_t> >(std::vector<size_t>{ 2, 0, 3 }, m.rowNnz());
+	assertEquals<std::vector<int> >(std::vector<int>{ 1, 0, 5 }, m.diagonal());
+
+	assertEquals<int>(7, m.norm(Matrix::NORM_1));
+	assertEquals<int>(12, m.norm(Matrix::NORM_INF));
+	assertEquals<int>(-4, m.min());
+	assertEquals<int>(5, m.max());
+
+	// zeros count only when the matrix has some
+	Matrix full(1, 2);
+	full.set(2, 0, 0).set(3, 0, 1);
+	assertEquals<int>(2, full.min());
+	assertEquals<int>(0, Matrix(2, 2).max());
+
+	Sparse::SparseMatrix<double> d(2);
+	d.set(3.0, 0, 0).set(4.0, 1, 1);
+	assertEquals<double>(5.0, d.norm());
+	assertEquals<std::vector<double> >(std::vector<double>{ 3.0, 4.0 }, d.rowNorms());
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testParallelReductions(void)
+{
+	std::cout << "parallel reductions..." << std::flush;
+
+	typedef Sparse::SparseMatrix<int> Matrix;
+
+	const size_t rows = 3000, cols = 2000;
+	Matrix m(rows, cols);
+	std::vector<std::vector<int> > dense(rows, std::vector<int>(cols, 0));
+
+	for (int k = 0; k < 100000; k++) {
+		size_t i = rand() % rows, j = rand() % cols;
+		int val = rand() % 201 - 100;
+
+		m.set(val, i, j);
+		dense[i][j] = val;
+	}
+
+	std::vector<int> rowSums(rows, 0), columnSums(cols, 0), rowMax(rows, 0), diagonal(cols, 0);
+	int frobenius = 0, minimum = 0, maximum = 0;
+
+	for (size_t i = 0; i < rows; i++) {
+		for (size_t j = 0; j < cols; j++) {
+			rowSums[i] += dense[i][j];
+			columnSums[j] += dense[i][j];
+			rowMax[i] = std::max(rowMax[i], std::abs(dense[i][j]));
+			frobenius += dense[i][j] * dense[i][j];
+			minimum = std::min(minimum, dense[i][j]);
+			maximum = std::max(maximum, dense[i][j]);
+		}
+
+		if (i < cols) {
+			diagonal[i] = dense[i][i];
+		}
+	}
+
+	size_t threads[] = { 1, 4 };
+
+	for (size_t t = 0; t < 2; t++) {
+		Sparse::Parallel::setThreadCount(threads[t]);
+
+		assertEquals<std::vector<int> >(rowSums, m.rowSums(), "Incorrect row sums");
+		assertEquals<std::vector<int> >(columnSums, m.columnSums(), "Incorrect column sums");
+		assertEquals<std::vector<int> >(rowMax, m.rowNorms(Matrix::NORM_INF), "Incorrect row norms");
+		assertEquals<std::vector<int> >(diagonal, m.diagonal(), "Incorrect diagonal");
+		assertEquals<int>(static_cast<int>(std::sqrt(frobenius)), m.norm(Matrix::NORM_FROBENIUS), "Incorrect Frobenius norm");
+		assertEquals<int>(minimum, m.min());
+		assertEquals<int>(maximum, m.max());
+	}
+
+	Sparse::Parallel::setThreadCount(0);
+
+	std::cout << " OK" << std::endl;
+}
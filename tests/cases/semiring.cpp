@@ -0,0 +1,106 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void testSemirings(void)
+{
+	std::cout << "semirings..." << std::flush;
+
+	/*
+		Directed weighted graph
+		[ 0 4 1 0 ]
+		[ 0 0 0 5 ]
+		[ 0 2 0 8 ]
+		[ 0 0 0 0 ]
+	*/
+
+	Sparse::SparseMatrix<int> graph(4);
+	graph.set(4, 0, 1)
+		.set(1, 0, 2)
+		.set(5, 1, 3)
+		.set(2, 2, 1)
+		.set(8, 2, 3);
+
+	// breadth-first search step: vertices reachable from {0}
+	std::vector<int> frontier { 1, 0, 0, 0 };
+	Sparse::SparseMatrix<int> adjacencyT(4);
+	for (size_t i = 0; i < 4; i++) {
+		for (size_t j = 0; j < 4; j++) {
+			adjacencyT.set(graph.get(j, i) == 0 ? 0 : 1, i, j);
+		}
+	}
+
+	std::vector<int> reached { 0, 1, 1, 0 };
+	assertEquals<std::vector<int> >(reached, adjacencyT.multiply<Sparse::OrAnd<int> >(frontier), "Incorrect (or, and) vector multiplication");
+
+	// shortest paths of length two
+	Sparse::SparseMatrix<int> twoHops = graph.multiply<Sparse::MinPlus<int> >(graph);
+
+	std::vector<std::vector<int> > expectedHops {
+		{ 0, 3, 0, 9 },
+		{ 0, 0, 0, 0 },
+		{ 0, 0, 0, 7 },
+		{ 0, 0, 0, 0 }
+	};
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(twoHops, expectedHops, "Incorrect (min, +) matrices multiplication");
+
+	// distances relaxed from vertex 0, unreachable vertices reduce to "infinity"
+	int inf = Sparse::MinPlus<int>::zero();
+	std::vector<int> distances { 0, inf, inf, inf };
+	Sparse::SparseMatrix<int> graphT(4);
+	for (size_t i = 0; i < 4; i++) {
+		for (size_t j = 0; j < 4; j++) {
+			graphT.set(graph.get(j, i), i, j);
+		}
+	}
+
+	std::vector<int> relaxed { inf, 4, 1, inf };
+	assertEquals<std::vector<int> >(relaxed, graphT.multiply<Sparse::MinPlus<int> >(distances), "Incorrect (min, +) vector multiplication");
+
+	// widest paths of length two
+	Sparse::SparseMatrix<int> widest = graph.multiply<Sparse::MaxMin<int> >(graph);
+
+	std::vector<std::vector<int> > expectedWidest {
+		{ 0, 1, 0, 4 },
+		{ 0, 0, 0, 0 },
+		{ 0, 0, 0, 2 },
+		{ 0, 0, 0, 0 }
+	};
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(widest, expectedWidest, "Incorrect (max, min) matrices multiplication");
+
+	// path of length 0 is a stored element, missing elements are zero() of the semiring
+	Sparse::SparseMatrix<int> there(2), back(2), mask(2);
+	there.set(-1, 0, 1);
+	back.set(1, 1, 0);
+	mask.set(1, 0, 0);
+
+	Sparse::SparseMatrix<int> roundTrip = there.multiply<Sparse::MinPlus<int> >(back);
+	assertEquals<size_t>(1, roundTrip.getNnz());
+	assertEquals<bool>(true, roundTrip.contains(0, 0));
+	assertEquals<bool>(false, roundTrip.contains(1, 1));
+	assertEquals<int>(0, roundTrip.get(0, 0));
+	assertEquals<bool>(true, there.multiplyMasked<Sparse::MinPlus<int> >(back, mask).contains(0, 0), "Path of length 0 dropped by masked multiplication");
+
+	// width 0 comes from an explicitly stored 0 on a shared pattern
+	Sparse::SparseMatrix<int> edge(2);
+	edge.set(1, 0, 1);
+
+	Sparse::SparseMatrix<int> closed(std::make_shared<const Sparse::SparsePattern>(edge), std::vector<int>{ 0 });
+	Sparse::SparseMatrix<int> narrowest = closed.multiply<Sparse::MaxMin<int> >(back);
+	assertEquals<bool>(true, narrowest.contains(0, 0));
+	assertEquals<int>(0, narrowest.get(0, 0));
+	assertEquals<size_t>(1, closed.multiplyMasked<Sparse::MaxMin<int> >(back, mask).getNnz());
+
+	// (+, *) is the default
+	assertEquals<Sparse::SparseMatrix<int> >(graph.multiply(graph), graph.multiply<Sparse::PlusTimes<int> >(graph), "Incorrect (+, *) matrices multiplication");
+
+	std::cout << " OK" << std::endl;
+}
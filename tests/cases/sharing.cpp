@@ -0,0 +1,99 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../inc/SparseMatrixMock.h"
+#include "../../src/SparseMatrix/SmallSparseMatrix.h"
+
+
+void testCopyOnWrite(void)
+{
+	std::cout << "copy-on-write..." << std::flush;
+
+	typedef Sparse::SparseMatrix<int> Matrix;
+
+	Matrix original(20, 30);
+	for (int k = 0; k < 100; k++) {
+		original.set(rand() % 9 + 1, rand() % 20, rand() % 30);
+	}
+
+	original.set(5, 3, 4);
+	const Matrix reference = original.transpose().transpose(); // own arrays, never shared with original
+
+	// copies share all arrays
+	SparseMatrixMock<int> mock(original);
+	SparseMatrixMock<int> mockCopy(mock);
+	assertEquals<bool>(true, mock.getValues() == mockCopy.getValues(), "Values copied instead of shared");
+	assertEquals<bool>(true, mock.getColumnPointers() == mockCopy.getColumnPointers(), "Columns copied instead of shared");
+	assertEquals<bool>(true, mock.getRowPointers() == mockCopy.getRowPointers(), "Rows copied instead of shared");
+
+	Matrix copy(original);
+	assertEquals<bool>(true, copy.isShared());
+	assertEquals<bool>(true, original.isShared());
+
+	// value change clones only the values
+	mockCopy.set(7, 3, 4);
+	assertEquals<bool>(false, mock.getValues() == mockCopy.getValues(), "Shared values changed in place");
+	assertEquals<bool>(true, mock.getRowPointers() == mockCopy.getRowPointers(), "Rows cloned by value change");
+	assertEquals<int>(5, mock.get(3, 4));
+	assertEquals<int>(7, mockCopy.get(3, 4));
+
+	// structure changes clone the structure
+	copy.set(0, 3, 4);
+	assertEquals<bool>(false, copy.isShared());
+	assertEquals<Matrix>(reference, original);
+	assertEquals<int>(0, copy.get(3, 4));
+
+	copy = original;
+	copy.set(1, 19, 29).set(1, 0, 0);
+	assertEquals<Matrix>(reference, original);
+
+	copy = original;
+	copy = copy; // self assignment keeps the arrays
+	assertEquals<Matrix>(reference, copy);
+
+	// in-place operations
+	std::vector<Matrix> copies(6, original);
+
+	copies[0].scale(2);
+	copies[1].axpy(-1, original);
+	copies[2].hadamard(original);
+	copies[3].apply([] (int val) { return val - 1; });
+	copies[4].setValues(std::vector<int>(original.getNnz(), 3));
+	copies[5].reserve(1000);
+	copies[5].shrinkToFit();
+
+	assertEquals<Matrix>(reference, original);
+	assertEquals<size_t>(0, copies[1].getNnz());
+	assertEquals<int>(reference.get(3, 4) * 2, copies[0].get(3, 4));
+	assertEquals<int>(reference.get(3, 4) * reference.get(3, 4), copies[2].get(3, 4));
+	assertEquals<int>(3, copies[4].get(3, 4));
+	assertEquals<Matrix>(reference, copies[5]);
+
+	// scatter of an element matrix
+	Sparse::SmallSparseMatrix<int, 2, 2> element;
+	element.set(1, 0, 0).set(1, 1, 1);
+
+	Matrix assembled(original);
+	element.scatterAdd(assembled, 3, 3);
+	assertEquals<Matrix>(reference, original);
+	assertEquals<int>(reference.get(4, 4) + 1, assembled.get(4, 4));
+
+	// copies of a matrix with shared pattern share its values too
+	std::shared_ptr<const Sparse::SparsePattern> pattern = std::make_shared<const Sparse::SparsePattern>(original);
+	Matrix patterned(pattern, std::vector<int>(pattern->getNnz(), 1));
+	Matrix patternedCopy(patterned);
+
+	assertEquals<bool>(true, patternedCopy.isShared());
+	patternedCopy.set(4, 3, 4);
+	assertEquals<int>(1, patterned.get(3, 4));
+	assertEquals<bool>(true, patternedCopy.getSharedPattern() == pattern, "Value change detached the pattern");
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,152 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/SmallSparseMatrix.h"
+
+
+void _smallCapacityFail(void)
+{
+	Sparse::SmallSparseMatrix<int, 3, 3, 2> m;
+	m.set(1, 0, 0).set(2, 1, 1).set(3, 2, 2);
+}
+
+
+void _smallGetFail(void)
+{
+	Sparse::SmallSparseMatrix<int, 3, 4> m;
+	m.get(3, 0);
+}
+
+
+void _smallScatterFail(void)
+{
+	Sparse::SmallSparseMatrix<int, 2, 2> m;
+	Sparse::SparseMatrix<int> target(4, 4);
+	m.scatterAdd(target, 3, 0);
+}
+
+
+void testSmallFail(void)
+{
+	std::cout << "small matrix fail..." << std::flush;
+	assertException("InvalidArgumentException", _smallCapacityFail);
+	assertException("InvalidCoordinatesException", _smallGetFail);
+	assertException("InvalidCoordinatesException", _smallScatterFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+template<size_t M, size_t N, size_t K>
+Sparse::SmallSparseMatrix<int, M, N, K> randomSmall(std::vector<std::vector<int> > & classic)
+{
+	Sparse::SmallSparseMatrix<int, M, N, K> small;
+	classic.assign(M, std::vector<int>(N, 0));
+
+	for (size_t k = 0; k < K; k++) {
+		size_t i = rand() % M, j = rand() % N;
+		classic[i][j] = rand() % 11 - 5;
+		small.set(classic[i][j], i, j);
+	}
+
+	return small;
+}
+
+
+void testSmall(void)
+{
+	std::cout << "small matrix..." << std::flush;
+
+	for (int t = 0; t < 20; t++) {
+		std::vector<std::vector<int> > a, b, c;
+		Sparse::SmallSparseMatrix<int, 8, 6, 20> sa = randomSmall<8, 6, 20>(a);
+		Sparse::SmallSparseMatrix<int, 6, 5, 15> sb = randomSmall<6, 5, 15>(b);
+		Sparse::SmallSparseMatrix<int, 8, 6, 30> sc = randomSmall<8, 6, 30>(c);
+
+		assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(sa.toMatrix(), a, "Incorrect small matrix values");
+
+		std::array<int, 6> x;
+		std::vector<int> vx(6);
+		for (size_t j = 0; j < 6; j++) {
+			vx[j] = x[j] = rand() % 21 - 10;
+		}
+
+		std::array<int, 8> product = sa * x;
+		assertEquals<std::vector<int> >(multiplyMatrixByVector(a, vx), std::vector<int>(product.begin(), product.end()), "Incorrect small vector multiplication");
+
+		// result types are derived from operand dimensions and capacities
+		Sparse::SmallSparseMatrix<int, 8, 5> sab = sa * sb;
+		assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(sab.toMatrix(), multiplyMatrices(a, b), "Incorrect small matrix multiplication");
+
+		Sparse::SmallSparseMatrix<int, 8, 6, 48> sac = sa + sc;
+		assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(sac.toMatrix(), addMatrices(a, c), "Incorrect small matrix addition");
+		assertEquals<size_t>(sac.toMatrix().getNnz(), sac.getNnz());
+	}
+
+	Sparse::SmallSparseMatrix<int, 2, 3> m;
+	m.set<1, 2>(7).set<0, 0>(-1);
+	assertEquals<int>(7, m.get<1, 2>());
+	assertEquals<size_t>(2, m.getNnz());
+
+	m.set<1, 2>(0);
+	assertEquals<size_t>(1, m.getNnz());
+	assertEquals<size_t>(6, (Sparse::SmallSparseMatrix<int, 2, 3>::getCapacity()));
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testSmallScatter(void)
+{
+	std::cout << "small matrix scatter..." << std::flush;
+
+	// assemble 1D stiffness matrix from overlapping 2x2 element matrices
+	const size_t elements = 50;
+
+	Sparse::SmallSparseMatrix<int, 2, 2> element;
+	element.set(1, 0, 0).set(-1, 0, 1).set(-1, 1, 0).set(1, 1, 1);
+
+	Sparse::SparseMatrix<int> assembled(elements + 1);
+	std::vector<std::vector<int> > expected(elements + 1, std::vector<int>(elements + 1, 0));
+
+	for (size_t e = 0; e < elements; e++) {
+		element.scatterAdd(assembled, e, e);
+
+		for (size_t i = 0; i < 2; i++) {
+			for (size_t j = 0; j < 2; j++) {
+				expected[e + i][e + j] += element.get(i, j);
+			}
+		}
+	}
+
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(assembled, expected, "Incorrect scatter");
+
+	// scatter through index maps, cancelling elements are removed
+	Sparse::SmallSparseMatrix<int, 2, 2> negative;
+	negative.set(-1, 0, 0).set(1, 0, 1);
+	negative.scatterAdd(assembled, std::array<size_t, 2>{{ 0, 7 }}, std::array<size_t, 2>{{ 0, 1 }});
+
+	expected[0][0] -= 1;
+	expected[0][1] += 1;
+
+	assertEquals<Sparse::SparseMatrix<int>, std::vector<std::vector<int> > >(assembled, expected, "Incorrect scatter with index maps");
+	assertEquals<size_t>(3 * elements - 1, assembled.getNnz());
+
+	// matrix on a shared pattern keeps cancelled elements and the pattern
+	std::shared_ptr<const Sparse::SparsePattern> pattern = std::make_shared<const Sparse::SparsePattern>(assembled);
+	Sparse::SparseMatrix<int> shared(pattern);
+
+	element.scatterAdd(shared, 3, 3);
+	negative.scatterAdd(shared, 3, 3);
+
+	assertEquals<int>(0, shared.get(3, 3));
+	assertEquals<size_t>(assembled.getNnz(), shared.getNnz());
+	assertEquals<bool>(true, shared.getSharedPattern() == pattern, "Scatter detached the shared pattern");
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,106 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <atomic>
+#include <thread>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/SnapshotHandle.h"
+
+
+void testSnapshots(void)
+{
+	std::cout << "snapshots..." << std::flush;
+
+	Sparse::SparseMatrix<int> matrix(8);
+	for (size_t i = 0; i < 8; i++) {
+		matrix.set(1, i, i);
+	}
+
+	// frozen copy is independent of the original
+	Sparse::SnapshotHandle<int>::Snapshot frozen = matrix.freeze();
+	matrix.set(2, 0, 0);
+	assertEquals<int>(1, frozen->get(0, 0));
+
+	// every published version holds a single value on the diagonal,
+	// readers must never see two versions mixed together
+	Sparse::SnapshotHandle<int> handle(frozen);
+	std::atomic<bool> done(false), consistent(true);
+	std::vector<std::thread> readers;
+
+	for (int r = 0; r < 4; r++) {
+		readers.push_back(std::thread([&] () {
+			std::vector<int> x(8, 1);
+
+			while (!done) {
+				Sparse::SnapshotHandle<int>::Snapshot snapshot = handle.acquire();
+				std::vector<int> y = snapshot->multiply(x);
+
+				for (size_t i = 0; i < 8; i++) {
+					if (y[i] != y[0] || snapshot->get(i, i) != y[0]) {
+						consistent = false;
+					}
+				}
+			}
+		}));
+	}
+
+	for (int version = 2; version < 200; version++) {
+		for (size_t i = 0; i < 8; i++) {
+			matrix.set(version, i, i);
+		}
+
+		handle.publish(matrix);
+	}
+
+	done = true;
+	for (size_t r = 0; r < readers.size(); r++) {
+		readers[r].join();
+	}
+
+	assertEquals<bool>(true, consistent, "Inconsistent snapshot read");
+	assertEquals<int>(199, handle.acquire()->get(7, 7));
+
+	// readers keep making progress while the writer publishes in a loop
+	assertEquals<bool>(true, Sparse::SnapshotHandle<int>::isLockFree());
+
+	std::atomic<bool> reading(true);
+	std::atomic<int> published(199);
+
+	std::thread writer([&] () {
+		Sparse::SparseMatrix<int> next(8);
+
+		for (int version = 200; reading; version++) {
+			next.set(version, 0, 0);
+			handle.publish(next);
+			published = version;
+		}
+	});
+
+	int last = 0;
+	bool monotonic = true;
+
+	// reads overlap with a number of publications
+	for (int k = 0; k < 20000 || published < 300; k++) {
+		int value = handle.acquire()->get(0, 0);
+		monotonic = monotonic && value >= last;
+		last = value;
+	}
+
+	reading = false;
+	writer.join();
+
+	assertEquals<bool>(true, monotonic, "Older version acquired after a newer one");
+	assertEquals<int>(published, handle.acquire()->get(0, 0));
+
+	// previous version stays alive while someone holds it
+	Sparse::SnapshotHandle<int>::Snapshot old = handle.exchange(frozen);
+	assertEquals<int>(published, old->get(0, 0));
+	assertEquals<int>(1, handle.acquire()->get(3, 3));
+
+	std::cout << " OK" << std::endl;
+}
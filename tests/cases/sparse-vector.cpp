@@ -0,0 +1,185 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../inc/SparseMatrixMock.h"
+#include "../../src/SparseMatrix/ColumnSparseMatrix.h"
+
+
+void _sparseVectorOrderFail(void)
+{
+	Sparse::SparseVector<int> vector(5, std::vector<size_t>{ 3, 1 }, std::vector<int>{ 1, 2 });
+}
+
+
+void _sparseVectorIndexFail(void)
+{
+	Sparse::SparseVector<int> vector(5);
+	vector.set(1, 5);
+}
+
+
+void _sparseVectorMultiplicationFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::ColumnSparseMatrix<int> columns(m);
+	columns.multiply(Sparse::SparseVector<int>(3));
+}
+
+
+void _sparseVectorZeroFail(void)
+{
+	Sparse::SparseMatrix<int> m(3);
+	Sparse::ColumnSparseMatrix<int> columns(m);
+	columns.multiply<Sparse::MinPlus<int> >(Sparse::SparseVector<int>(3));
+}
+
+
+void testSparseVectorFail(void)
+{
+	std::cout << "sparse vector fail..." << std::flush;
+	assertException("InvalidArgumentException", _sparseVectorOrderFail);
+	assertException("InvalidCoordinatesException", _sparseVectorIndexFail);
+	assertException("InvalidDimensionsException", _sparseVectorMultiplicationFail);
+	assertException("InvalidArgumentException", _sparseVectorZeroFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testSparseVector(void)
+{
+	std::cout << "sparse vector..." << std::flush;
+
+	std::vector<int> dense { 0, 3, 0, 0, 7, 0, 1 };
+	Sparse::SparseVector<int> vector(dense);
+
+	assertEquals<size_t>(7, vector.getSize());
+	assertEquals<size_t>(3, vector.getNnz());
+	assertEquals<std::vector<size_t> >(std::vector<size_t>{ 1, 4, 6 }, vector.getIndices());
+	assertEquals<std::vector<int> >(dense, vector.toDense());
+
+	vector.set(5, 2).set(0, 4).set(9, 6);
+	assertEquals<std::vector<int> >(std::vector<int>{ 0, 3, 5, 0, 0, 0, 9 }, vector.toDense());
+	assertEquals<bool>(false, vector.contains(4));
+
+	// bitmap follows modifications
+	vector.enableBitmap();
+	assertEquals<bool>(true, vector.hasBitmap());
+	assertEquals<bool>(true, vector.contains(2));
+	assertEquals<bool>(false, vector.contains(3));
+
+	vector.set(4, 3).set(0, 2);
+	assertEquals<bool>(true, vector.contains(3));
+	assertEquals<bool>(false, vector.contains(2));
+	assertEquals<int>(4, vector.get(3));
+	assertEquals<int>(0, vector.get(2));
+
+	// explicit zeros are dropped
+	Sparse::SparseVector<int> fromArrays(7, std::vector<size_t>{ 1, 2, 3, 6 }, std::vector<int>{ 3, 0, 4, 9 });
+	assertEquals<Sparse::SparseVector<int> >(vector, fromArrays);
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testSparseVectorMultiplication(void)
+{
+	std::cout << "sparse matrix - sparse vector multiplication..." << std::flush;
+
+	// random rectangular matrices against dense multiplication
+	for (int k = 0; k < 20; k++) {
+		size_t rows = rand() % 50 + 1, cols = rand() % 50 + 1;
+		Sparse::SparseMatrix<int> matrix(rows, cols);
+
+		for (int e = 0, count = rand() % 200; e < count; e++) {
+			matrix.set(rand() % 21 - 10, rand() % rows, rand() % cols);
+		}
+
+		Sparse::ColumnSparseMatrix<int> columns(matrix);
+		assertEquals<Sparse::SparseMatrix<int> >(matrix, columns.toMatrix());
+		assertEquals<size_t>(matrix.getNnz(), columns.getNnz());
+
+		Sparse::SparseVector<int> x(cols);
+		for (int e = 0, count = rand() % 5; e < count; e++) {
+			x.set(rand() % 21 - 10, rand() % cols);
+		}
+
+		std::vector<int> expected = matrix * x.toDense();
+		assertEquals<Sparse::SparseVector<int> >(Sparse::SparseVector<int>(expected), columns * x, "Incorrect sparse vector multiplication");
+	}
+
+	// shortest paths from a source at distance 0, missing elements are "infinity"
+	typedef Sparse::MinPlus<int> Paths;
+
+	Sparse::SparseMatrix<int> roads(4);
+	roads.set(4, 0, 1).set(1, 0, 2).set(-1, 2, 3);
+
+	Sparse::ColumnSparseMatrix<int> incoming(roads.transpose());
+	Sparse::SparseVector<int> distances(4, std::vector<size_t>{ 0 }, std::vector<int>{ 0 }, Paths::zero());
+	assertEquals<size_t>(1, distances.getNnz());
+	assertEquals<int>(0, distances.get(0));
+	assertEquals<int>(Paths::zero(), distances.get(3));
+
+	distances = incoming.multiply<Paths>(distances);
+	assertEquals<Sparse::SparseVector<int> >(Sparse::SparseVector<int>(4, std::vector<size_t>{ 1, 2 }, std::vector<int>{ 4, 1 }, Paths::zero()), distances);
+
+	// 1 + (-1) is a path of length 0, not a missing one
+	distances = incoming.multiply<Paths>(distances);
+	assertEquals<std::vector<size_t> >(std::vector<size_t>{ 3 }, distances.getIndices());
+	assertEquals<int>(0, distances.get(3));
+
+	// breadth-first search on a graph too large for the accumulator to be dense
+	typedef Sparse::OrAnd<int> Boolean;
+
+	const size_t n = 1 << 18;
+	std::vector<size_t> rows(1, 0), cols;
+
+	// CRS arrays directly, inserting this many elements one by one would shift the row pointers each time
+	for (size_t i = 0; i < n; i++) {
+		size_t a = std::min((i + 1) % n, (i * 7 + 3) % n), b = std::max((i + 1) % n, (i * 7 + 3) % n);
+
+		cols.push_back(a);
+		if (b != a) {
+			cols.push_back(b);
+		}
+
+		rows.push_back(cols.size());
+	}
+
+	std::vector<int> vals(cols.size(), 1);
+	SparseMatrixMock<int> adjacency = SparseMatrixMock<int>::fromArrays(n, n, std::move(rows), std::move(cols), std::move(vals));
+
+	Sparse::ColumnSparseMatrix<int> transposed(adjacency.transpose());
+
+	Sparse::SparseVector<int> visited(n), frontier(n);
+	visited.enableBitmap();
+	visited.set(1, 0);
+	frontier.set(1, 0);
+
+	std::vector<size_t> sizes;
+
+	for (int level = 0; level < 4; level++) {
+		frontier = transposed.multiplyMasked<Boolean>(frontier, visited, true);
+		sizes.push_back(frontier.getNnz());
+
+		for (size_t v : frontier.getIndices()) {
+			visited.set(1, v);
+		}
+	}
+
+	// v -> v + 1, 7v + 3: 0 -> { 1, 3 } -> { 2, 4, 10, 24 } -> ... with 3 already visited
+	assertEquals<std::vector<size_t> >(std::vector<size_t>{ 1, 3 }, transposed.multiply<Boolean>(Sparse::SparseVector<int>(n, std::vector<size_t>{ 0 }, std::vector<int>{ 1 })).getIndices());
+	assertEquals<size_t>(2, sizes[0]);
+	assertEquals<size_t>(4, sizes[1]);
+	assertEquals<size_t>(7, sizes[2]);
+	assertEquals<size_t>(14, sizes[3]);
+	assertEquals<size_t>(28, visited.getNnz());
+
+	std::cout << " OK" << std::endl;
+}
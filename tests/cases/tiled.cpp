@@ -0,0 +1,58 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/TiledSparseMatrix.h"
+
+
+void _tiledFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	Sparse::TiledSparseMatrix<int> tiled(m, 0);
+}
+
+
+void testTiledFail(void)
+{
+	std::cout << "tiled matrix fail..." << std::flush;
+	assertException("InvalidArgumentException", _tiledFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testTiledMultiplication(void)
+{
+	std::cout << "tiled vector multiplication..." << std::flush;
+
+	// small matrices with all kinds of tile widths, one large enough to run in parallel
+	int sizes[][3] = { { 5, 17, 20 }, { 30, 100, 400 }, { 2000, 5000, 40000 } };
+	size_t widths[] = { 1, 3, 16, 64, 1000, 100000 };
+
+	for (int s = 0; s < 3; s++) {
+		int rows = sizes[s][0], cols = sizes[s][1];
+
+		Sparse::SparseMatrix<int> matrix(rows, cols);
+		for (int k = 0; k < sizes[s][2]; k++) {
+			matrix.set(rand() % 101 - 50, rand() % rows, rand() % cols);
+		}
+
+		std::vector<int> x = generateRandomVector<int>(cols);
+		std::vector<int> expected = matrix.multiply(x);
+
+		for (size_t w = 0; w < 6; w++) {
+			Sparse::TiledSparseMatrix<int> tiled(matrix, widths[w]);
+
+			assertEquals<size_t>((cols + widths[w] - 1) / widths[w], tiled.getTileCount());
+			assertEquals<size_t>(matrix.getNnz(), tiled.getNnz());
+			assertEquals<std::vector<int> >(expected, tiled * x, "Incorrect tiled vector multiplication");
+			assertEquals<std::vector<int> >(matrix.multiply<Sparse::MinPlus<int> >(x), tiled.multiply<Sparse::MinPlus<int> >(x), "Incorrect tiled (min, +) vector multiplication");
+		}
+	}
+
+	std::cout << " OK" << std::endl;
+}
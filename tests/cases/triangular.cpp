@@ -0,0 +1,179 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cmath>
+#include <functional>
+#include "../inc/testslib.h"
+#include "../../src/SparseMatrix/TriangularSolver.h"
+
+
+void _triangularSquareFail(void)
+{
+	Sparse::SparseMatrix<double> m(3, 4);
+	Sparse::TriangularSolver<double> solver(m, Sparse::TriangularSolver<double>::LOWER, Sparse::TriangularSolver<double>::UNIT);
+}
+
+
+void _triangularDiagonalFail(void)
+{
+	Sparse::SparseMatrix<double> m(3);
+	m.set(1.0, 0, 0).set(1.0, 2, 2).set(4.0, 2, 0);
+	Sparse::TriangularSolver<double> solver(m, Sparse::TriangularSolver<double>::LOWER);
+}
+
+
+void _triangularUpdateFail(void)
+{
+	Sparse::SparseMatrix<double> m(3);
+	m.set(1.0, 1, 0);
+	Sparse::TriangularSolver<double> solver(m, Sparse::TriangularSolver<double>::LOWER, Sparse::TriangularSolver<double>::UNIT);
+
+	m.set(1.0, 2, 1);
+	solver.update(m);
+}
+
+
+void testTriangularFail(void)
+{
+	std::cout << "triangular solve fail..." << std::flush;
+	assertException("InvalidDimensionsException", _triangularSquareFail);
+	assertException("InvalidArgumentException", _triangularDiagonalFail);
+	assertException("InvalidArgumentException", _triangularUpdateFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+/** @return Largest residual element of triangle * x - b, triangle taken from full matrix */
+double triangularResidual(const Sparse::SparseMatrix<double> & matrix, bool lower, bool unit, const std::vector<double> & x, const std::vector<double> & b)
+{
+	double residual = 0.0;
+
+	for (size_t i = 0; i < matrix.getRowCount(); i++) {
+		double sum = unit ? x[i] : matrix.get(i, i) * x[i];
+
+		for (size_t j = 0; j < matrix.getColumnCount(); j++) {
+			if (lower ? j < i : j > i) {
+				sum += matrix.get(i, j) * x[j];
+			}
+		}
+
+		residual = std::max(residual, std::abs(sum - b[i]));
+	}
+
+	return residual;
+}
+
+
+void testTriangularSolve(void)
+{
+	std::cout << "triangular solve..." << std::flush;
+
+	typedef Sparse::TriangularSolver<double> Solver;
+
+	// L and U stored in one matrix
+	const size_t n = 60;
+	Sparse::SparseMatrix<double> lu(n);
+	std::vector<double> b(n);
+
+	for (size_t i = 0; i < n; i++) {
+		lu.set(2.0 + rand() % 5, i, i);
+		b[i] = rand() % 21 - 10;
+
+		for (int k = 0; k < 4; k++) {
+			lu.set((rand() % 201 - 100) / 100.0 + 0.005, i, rand() % n);
+		}
+	}
+
+	for (int lower = 0; lower < 2; lower++) {
+		for (int unit = 0; unit < 2; unit++) {
+			Solver solver(lu, lower ? Solver::LOWER : Solver::UPPER, unit ? Solver::UNIT : Solver::EXPLICIT);
+			std::vector<double> x = solver.solve(b);
+
+			if (triangularResidual(lu, lower, unit, x, b) > 1e-6) {
+				throw FailureException("Incorrect triangular solve");
+			}
+		}
+	}
+
+	// diagonal matrix is one level, bidiagonal one is a chain
+	Sparse::SparseMatrix<double> diagonal(5), chain(5);
+	for (size_t i = 0; i < 5; i++) {
+		diagonal.set(2.0, i, i);
+		chain.set(1.0, i, i);
+
+		if (i > 0) {
+			chain.set(-1.0, i, i - 1);
+		}
+	}
+
+	assertEquals<size_t>(1, Solver(diagonal, Solver::LOWER).getLevelCount());
+	assertEquals<size_t>(5, Solver(chain, Solver::LOWER).getLevelCount());
+	assertEquals<size_t>(1, Solver(chain, Solver::UPPER).getLevelCount());
+
+	// prefix sums
+	assertEquals<std::vector<double> >(std::vector<double>{ 1, 3, 6, 10, 15 }, Solver(chain, Solver::LOWER).solve(std::vector<double>{ 1, 2, 3, 4, 5 }));
+
+	// new values, same pattern
+	Solver solver(chain, Solver::LOWER);
+	chain.scale(2.0);
+	solver.update(chain);
+	assertEquals<std::vector<double> >(std::vector<double>{ 0.5, 1.5, 3, 5, 7.5 }, solver.solve(std::vector<double>{ 1, 2, 3, 4, 5 }));
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testParallelTriangularSolve(void)
+{
+	std::cout << "parallel triangular solve..." << std::flush;
+
+	typedef Sparse::TriangularSolver<double> Solver;
+
+	// rows depend only on previous blocks of rows, which gives wide levels
+	const size_t n = 20000, block = 200;
+	std::vector<Sparse::SparseMatrix<double> > blocks;
+	std::vector<double> b(n);
+
+	for (size_t first = 0; first < n; first += block) {
+		blocks.push_back(Sparse::SparseMatrix<double>(block, n));
+
+		for (size_t i = 0; i < block; i++) {
+			blocks.back().set(4.0, i, first + i);
+			b[first + i] = rand() % 21 - 10;
+
+			for (int k = 0; first > 0 && k < 5; k++) {
+				blocks.back().set((rand() % 201 - 100) / 100.0 + 0.005, i, rand() % first);
+			}
+		}
+	}
+
+	Sparse::SparseMatrix<double> lower = Sparse::SparseMatrix<double>::vstack(
+		std::vector<std::reference_wrapper<const Sparse::SparseMatrix<double> > >(blocks.begin(), blocks.end()));
+
+	Solver forward(lower, Solver::LOWER), backward(lower.transpose(), Solver::UPPER);
+	assertEquals<bool>(true, forward.getLevelCount() <= n / block);
+
+	Sparse::Parallel::setThreadCount(1);
+	std::vector<double> sequential = forward.solve(b), sequentialBackward = backward.solve(b);
+
+	Sparse::Parallel::setThreadCount(4);
+	assertEquals<std::vector<double> >(sequential, forward.solve(b), "Incorrect parallel forward substitution");
+	assertEquals<std::vector<double> >(sequentialBackward, backward.solve(b), "Incorrect parallel backward substitution");
+
+	Sparse::Parallel::setThreadCount(0);
+
+	// check residual of some rows
+	std::vector<double> product = lower * sequential;
+	for (size_t i = 0; i < n; i += 97) {
+		if (std::abs(product[i] - b[i]) > 1e-6) {
+			throw FailureException("Incorrect forward substitution");
+		}
+	}
+
+	std::cout << " OK" << std::endl;
+}
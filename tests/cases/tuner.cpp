@@ -0,0 +1,157 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include "../inc/testslib.h"
+#include "../inc/helpers.h"
+#include "../../src/SparseMatrix/AutoTuner.h"
+
+
+void testTunerFeatures(void)
+{
+	std::cout << "tuner features..." << std::flush;
+
+	typedef Sparse::AutoTuner<double> Tuner;
+
+	Sparse::SparseMatrix<double> tridiagonal(5);
+	for (size_t i = 0; i < 5; i++) {
+		tridiagonal.set(2.0, i, i);
+
+		if (i > 0) {
+			tridiagonal.set(-1.0, i, i - 1).set(-1.0, i - 1, i);
+		}
+	}
+
+	Sparse::MatrixFeatures features = Tuner::analyze(tridiagonal);
+	assertEquals<size_t>(13, features.nnz);
+	assertEquals<double>(2.6, features.rowMean);
+	assertEquals<size_t>(3, features.rowMax);
+	assertEquals<size_t>(1, features.bandwidth);
+	assertEquals<size_t>(1, features.gapMax);
+	assertEquals<double>(1.0, features.diagonalFill);
+	assertEquals<bool>(true, features.symmetric);
+	assertEquals<bool>(true, std::abs(features.rowVariance - 0.24) < 1e-12);
+
+	// both block rows touch both block columns
+	assertEquals<double>(13.0 / 64, features.blockDensity);
+
+	tridiagonal.set(-3.0, 0, 1);
+	assertEquals<bool>(false, Tuner::analyze(tridiagonal).symmetric);
+
+	// fingerprint depends on the pattern only
+	Sparse::SparseMatrix<double> scaled = tridiagonal;
+	scaled.scale(2.0);
+	assertEquals<uint64_t>(Tuner::fingerprint(tridiagonal), Tuner::fingerprint(scaled));
+
+	scaled.set(1.0, 4, 0);
+	assertEquals<bool>(true, Tuner::fingerprint(tridiagonal) != Tuner::fingerprint(scaled));
+
+	// element without its mirror, gap measured within rows
+	features = Tuner::analyze(scaled);
+	assertEquals<bool>(false, features.symmetric);
+	assertEquals<size_t>(3, features.gapMax);
+	assertEquals<size_t>(4, features.bandwidth);
+
+	std::cout << " OK" << std::endl;
+}
+
+
+void testTuner(void)
+{
+	std::cout << "tuner..." << std::flush;
+
+	typedef Sparse::AutoTuner<double> Tuner;
+
+	// stencil goes to DIA
+	const size_t side = 60, n = side * side;
+	Sparse::SparseMatrix<double> stencil(n);
+
+	for (size_t i = 0; i < n; i++) {
+		stencil.set(4.0, i, i);
+
+		if (i % side > 0) {
+			stencil.set(-1.0, i, i - 1).set(-1.0, i - 1, i);
+		}
+
+		if (i >= side) {
+			stencil.set(-1.0, i, i - side).set(-1.0, i - side, i);
+		}
+	}
+
+	std::vector<double> x(n);
+	for (size_t i = 0; i < n; i++) {
+		x[i] = rand() % 21 - 10;
+	}
+
+	Sparse::OptimizedOperator<double> op = Tuner::tune(stencil);
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::DIAGONAL), static_cast<int>(op.getFormat()));
+	assertEquals<std::vector<double> >(stencil * x, op * x);
+
+	// clustered random matrix goes to compressed indices
+	Sparse::SparseMatrix<double> clustered(4000);
+	for (size_t i = 0; i < 4000; i++) {
+		for (int k = 0; k < 12; k++) {
+			size_t j = std::min<size_t>(3999, i + rand() % 200);
+			clustered.set(1.0 + rand() % 5, i, j);
+		}
+	}
+
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::DELTA), static_cast<int>(Tuner::choose(Tuner::analyze(clustered))));
+
+	// clusters far from the diagonal compress just as well
+	Sparse::SparseMatrix<double> shifted(4000);
+	for (size_t i = 0; i < 4000; i++) {
+		for (size_t k = 0; k < 12; k++) {
+			shifted.set(1.0, i, (i * 37) % 3900 + 8 * k);
+		}
+	}
+
+	Sparse::MatrixFeatures shiftedFeatures = Tuner::analyze(shifted);
+	assertEquals<bool>(true, shiftedFeatures.bandwidth > UINT8_MAX);
+	assertEquals<size_t>(8, shiftedFeatures.gapMax);
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::DELTA), static_cast<int>(Tuner::choose(shiftedFeatures)));
+
+	// hub rows go to the hybrid format
+	Sparse::MatrixFeatures hubs = Tuner::analyze(clustered);
+	hubs.rowMax = 100000;
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::HYBRID), static_cast<int>(Tuner::choose(hubs)));
+
+	// every format multiplies correctly, benchmark picks one of them
+	std::vector<double> y(4000, 1.0);
+	std::vector<double> expected = clustered * y;
+
+	for (int f = 0; f <= static_cast<int>(Sparse::StorageFormat::HYBRID); f++) {
+		Sparse::OptimizedOperator<double> candidate = Tuner::create(clustered, static_cast<Sparse::StorageFormat>(f));
+		assertEquals<std::vector<double> >(expected, candidate * y, "Incorrect multiplication in chosen format");
+	}
+
+	Tuner::Options options;
+	options.benchmark = true;
+	options.repetitions = 2;
+	assertEquals<std::vector<double> >(expected, Tuner::tune(clustered, options) * y);
+
+	// decision is cached by fingerprint
+	std::string cache = "sparsematrix-tuner-" + std::to_string(rand()) + ".cache";
+	options = Tuner::Options();
+	options.cacheFile = cache;
+
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::DIAGONAL), static_cast<int>(Tuner::tune(stencil, options).getFormat()));
+
+	{
+		std::ofstream output(cache, std::ios::app);
+		output << Tuner::fingerprint(stencil) << " TILED\n";
+	}
+
+	assertEquals<int>(static_cast<int>(Sparse::StorageFormat::TILED), static_cast<int>(Tuner::tune(stencil, options).getFormat()));
+	std::remove(cache.c_str());
+
+	std::cout << " OK" << std::endl;
+}
@@ -0,0 +1,110 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+#include <thread>
+#include "../inc/testslib.h"
+#include "../inc/SparseMatrixMock.h"
+
+
+void _rowRangeFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	m.rowRange(2, 4);
+}
+
+
+void _submatrixFail(void)
+{
+	Sparse::SparseMatrix<int> m(3, 4);
+	m.submatrix({ 0, 1 }, { 2, 2 });
+}
+
+
+void testViewsFail(void)
+{
+	std::cout << "views fail..." << std::flush;
+	assertException("InvalidCoordinatesException", _rowRangeFail);
+	assertException("InvalidArgumentException", _submatrixFail);
+	std::cout << " OK" << std::endl;
+}
+
+
+void testViews(void)
+{
+	std::cout << "views and submatrices..." << std::flush;
+
+	std::vector<std::vector<int> > classic = generateRandomMatrix<int>(12, 9);
+	for (size_t i = 0; i < 12; i++) {
+		for (size_t j = 0; j < 9; j++) {
+			if (rand() % 3 != 0) {
+				classic[i][j] = 0;
+			}
+		}
+	}
+
+	SparseMatrixMock<int> matrix = SparseMatrixMock<int>::fromVectors(classic);
+	std::vector<int> x = generateRandomVector<int>(9);
+
+	// contiguous rows share storage with the matrix
+	Sparse::SparseMatrixView<int> view = matrix.rowRange(3, 8);
+	assertEquals<size_t>(5, view.getRowCount());
+	assertEquals<size_t>(9, view.getColumnCount());
+	assertEquals<size_t>(3, view.getFirstRow());
+
+	for (size_t i = 0; i < 5; i++) {
+		for (size_t j = 0; j < 9; j++) {
+			assertEquals<int>(classic[i + 3][j], view.get(i, j), "Incorrect view value");
+		}
+	}
+
+	std::vector<std::vector<int> > classicRows(classic.begin() + 3, classic.begin() + 8);
+	assertEquals<std::vector<int> >(multiplyMatrixByVector(classicRows, x), view * x, "Incorrect view vector multiplication");
+
+	std::vector<size_t> rowIndices { 3, 4, 5, 6, 7 };
+	std::vector<size_t> allColumns { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+	assertEquals<Sparse::SparseMatrix<int> >(matrix.submatrix(rowIndices, allColumns), view.toMatrix(), "Incorrect view copy");
+
+	// views processed by separate threads
+	std::vector<Sparse::SparseMatrixView<int> > parts = matrix.partitionRows(3);
+	std::vector<int> y(12, 0);
+	std::vector<std::thread> threads;
+
+	size_t covered = 0;
+	for (size_t p = 0; p < parts.size(); p++) {
+		assertEquals<size_t>(covered, parts[p].getFirstRow());
+		covered += parts[p].getRowCount();
+
+		threads.push_back(std::thread([&parts, &x, &y, p] () {
+			std::vector<int> partial = parts[p].multiply(x);
+			std::copy(partial.begin(), partial.end(), y.begin() + parts[p].getFirstRow());
+		}));
+	}
+
+	for (size_t t = 0; t < threads.size(); t++) {
+		threads[t].join();
+	}
+
+	assertEquals<size_t>(12, covered);
+	assertEquals<std::vector<int> >(matrix.multiply(x), y, "Incorrect partitioned vector multiplication");
+
+	// index set submatrix with permuted and repeated rows, permuted columns
+	std::vector<size_t> pickedRows { 11, 0, 4, 4 };
+	std::vector<size_t> pickedColumns { 8, 2, 5 };
+	Sparse::SparseMatrix<int> sub = matrix.submatrix(pickedRows, pickedColumns);
+
+	Sparse::SparseMatrix<int> expected(4, 3);
+	for (size_t r = 0; r < 4; r++) {
+		for (size_t c = 0; c < 3; c++) {
+			expected.set(classic[pickedRows[r]][pickedColumns[c]], r, c);
+		}
+	}
+
+	assertEquals<Sparse::SparseMatrix<int> >(expected, sub, "Incorrect submatrix");
+
+	std::cout << " OK" << std::endl;
+}
@@ -25,11 +25,9 @@
 
 		public:
 
-            SparseMatrixMock(const Sparse::SparseMatrix<T>& m)
-            : Sparse::SparseMatrix<T>(m.getRowCount(), m.getColumnCount())
-            {
-                Sparse::SparseMatrix<T>::deepCopy(m);
-            }
+            SparseMatrixMock(const Sparse::SparseMatrix<T>& m) : Sparse::SparseMatrix<T>(m)
+            {}
+
 			SparseMatrixMock(size_t n) : Sparse::SparseMatrix<T>(n)
 			{}
 
@@ -41,21 +39,21 @@
 			/** @return Non-empty values in the matrix */
 			std::vector<T> * getValues(void)
 			{
-				return this->vals;
+				return this->vals.get();
 			}
 
 
 			/** @return Column pointers */
 			std::vector<size_t> * getColumnPointers(void)
 			{
-				return this->cols;
+				return this->cols.get();
 			}
 
 
 			/** @return Row pointers */
 			std::vector<size_t> * getRowPointers(void)
 			{
-				return this->rows;
+				return this->rows.get();
 			}
 
 
@@ -120,6 +118,16 @@
 			}
 
 
+			/** @return Constructed SparseMatrix, rows[i] .. rows[i + 1] of cols and vals hold row i with ascending columns */
+			static SparseMatrixMock<T> fromArrays(size_t rowCount, size_t columnCount, std::vector<size_t> rows, std::vector<size_t> cols, std::vector<T> vals)
+			{
+				SparseMatrixMock<T> matrix(rowCount, columnCount);
+				matrix.assign(std::move(rows), std::move(cols), std::move(vals));
+
+				return matrix;
+			}
+
+
 			/** @return Constructed SparseMatrix */
 			static SparseMatrixMock<T> fromVectors(std::vector<std::vector<T> > vec)
 			{
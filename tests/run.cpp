@@ -30,12 +30,65 @@ void testSubtractionFail3();
 void testGettersAndSetters();
 void testInternalStorage();
 void testColumnMatrix();
+void testTranspose();
 void testOutput();
 void testVectorMultiplication();
 void testMatricesMultiplication();
+void testParallelMatricesMultiplication();
+void testThreadPool();
+void testParallelKernels();
+void testMaskedMultiplicationFail();
+void testMaskedMultiplication();
+void testCompositionFail();
+void testComposition();
+void testViewsFail();
+void testViews();
+void testInPlaceFail();
+void testInPlace();
+void testReductionsFail();
+void testReductions();
+void testParallelReductions();
+void testTiledFail();
+void testTiledMultiplication();
+void testDeltaFail();
+void testDeltaMultiplication();
+void testHybridFail();
+void testHybridMultiplication();
+void testDiagonalFail();
+void testDiagonalMatrix();
+void testSparseVectorFail();
+void testSparseVector();
+void testSparseVectorMultiplication();
+void testTunerFeatures();
+void testTuner();
+void testPartitionedFail();
+void testSharedRing();
+void testPartitionedMultiplication();
+void testCompactFail();
+void testHalfPrecision();
+void testCompactMultiplication();
+void testSmallFail();
+void testSmall();
+void testSmallScatter();
+void testTriangularFail();
+void testTriangularSolve();
+void testParallelTriangularSolve();
+void testCholeskyFail();
+void testCholeskySolve();
+void testCholeskyOrdering();
 void testAddition();
 void testSubtraction();
 void testElementTypes();
+void testSemirings();
+void testPatternFail();
+void testPattern();
+void testSharedPatternFail();
+void testSharedPattern();
+void testCopyOnWrite();
+void testNumericOperations();
+void testSnapshots();
+void testReserveFail();
+void testCapacity();
 
 int main(int argc, char ** argv)
 {
@@ -61,12 +114,65 @@ int main(int argc, char ** argv)
 		testGettersAndSetters();
 		testInternalStorage();
         testColumnMatrix();
+        testTranspose();
 		testOutput();
 		testVectorMultiplication();
 		testMatricesMultiplication();
+		testParallelMatricesMultiplication();
+		testThreadPool();
+		testParallelKernels();
+		testMaskedMultiplicationFail();
+		testMaskedMultiplication();
+		testCompositionFail();
+		testComposition();
+		testViewsFail();
+		testViews();
+		testInPlaceFail();
+		testInPlace();
+		testReductionsFail();
+		testReductions();
+		testParallelReductions();
+		testTiledFail();
+		testTiledMultiplication();
+		testDeltaFail();
+		testDeltaMultiplication();
+		testHybridFail();
+		testHybridMultiplication();
+		testDiagonalFail();
+		testDiagonalMatrix();
+		testSparseVectorFail();
+		testSparseVector();
+		testSparseVectorMultiplication();
+		testTunerFeatures();
+		testTuner();
+		testPartitionedFail();
+		testSharedRing();
+		testPartitionedMultiplication();
+		testCompactFail();
+		testHalfPrecision();
+		testCompactMultiplication();
+		testSmallFail();
+		testSmall();
+		testSmallScatter();
+		testTriangularFail();
+		testTriangularSolve();
+		testParallelTriangularSolve();
+		testCholeskyFail();
+		testCholeskySolve();
+		testCholeskyOrdering();
 		testAddition();
 		testSubtraction();
 		testElementTypes();
+		testSemirings();
+		testPatternFail();
+		testPattern();
+		testSharedPatternFail();
+		testSharedPattern();
+		testCopyOnWrite();
+		testNumericOperations();
+		testSnapshots();
+		testReserveFail();
+		testCapacity();
 
 	} catch (const FailureException & e) {
 		std::cout << " - FAIL: '" << e.getMessage() << "'" << std::endl;
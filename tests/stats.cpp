@@ -0,0 +1,78 @@
+/**
+ * This file is part of the SparseMatrix library
+ *
+ * @license  MIT
+ * @author   Petr Kessler (https://kesspess.cz)
+ * @link     https://github.com/uestla/Sparse-Matrix
+ */
+
+// separate runner built with -DSPARSEMATRIX_STATS for all of its sources,
+// see the Makefile - statistics have to be enabled in the whole program
+
+#include <ctime>
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+#include "inc/testslib.h"
+
+#ifndef SPARSEMATRIX_STATS
+	#error "Build the statistics tests with -DSPARSEMATRIX_STATS."
+#endif
+
+
+void testStats(void)
+{
+	std::cout << "operation statistics..." << std::flush;
+
+	Sparse::Stats::instance().reset();
+
+	Sparse::SparseMatrix<long> m(3, 4);
+	m.set(1, 0, 3) // no shift
+		.set(2, 0, 1) // shifts 1
+		.set(3, 0, 0) // shifts 2
+		.set(0, 0, 0); // removal shifts 2
+
+	Sparse::Stats::Report report = Sparse::Stats::instance().report();
+
+	assertEquals<uint64_t>(4, report.operations[Sparse::Stats::SET].calls);
+	assertEquals<uint64_t>(3, report.operations[Sparse::Stats::INSERT].calls);
+	assertEquals<uint64_t>(3, report.operations[Sparse::Stats::INSERT].shifted);
+	assertEquals<uint64_t>(1, report.operations[Sparse::Stats::REMOVE].calls);
+	assertEquals<uint64_t>(2, report.operations[Sparse::Stats::REMOVE].shifted);
+	assertEquals<uint64_t>(3, report.nnzHighWater);
+	assertEquals<bool>(true, report.bytesAllocated >= 5 * sizeof(size_t));
+
+	m.get(0, 1);
+	m.multiply(std::vector<long>(4, 1));
+	m.add(m);
+	m.subtract(m);
+
+	report = Sparse::Stats::instance().report();
+
+	assertEquals<uint64_t>(1, report.operations[Sparse::Stats::MULTIPLY_VECTOR].calls);
+	assertEquals<uint64_t>(1, report.operations[Sparse::Stats::ADD].calls);
+	assertEquals<uint64_t>(1, report.operations[Sparse::Stats::SUBTRACT].calls);
+
+	std::ostringstream json;
+	report.toJson(json);
+	assertEquals<bool>(true, json.str().find("\"remove\": {\"calls\": 1") != std::string::npos, "Incorrect JSON output");
+
+	std::cout << " OK" << std::endl;
+}
+
+
+int main(int argc, char ** argv)
+{
+	srand(static_cast<unsigned int>(time(nullptr)));
+
+	try {
+
+		testStats();
+
+	} catch (const FailureException & e) {
+		std::cout << " - FAIL: '" << e.getMessage() << "'" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}